@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "utl/parser/simd_scanner.h"
+
+namespace utl {
+
+// Assigns dense indices 0, 1, 2, ... to keys in order of first insertion.
+// Open addressing over groups of 16 control bytes: each byte holds 7 bits
+// of the key hash (or kEmpty), a group is matched with one SSE2 compare.
+// There is no erase, so probing stops at the first group with an empty
+// slot.
+template <typename Key, typename Hash = std::hash<Key>,
+          typename Eq = std::equal_to<Key>>
+struct hash_index {
+  static constexpr auto const kGroupSize = std::size_t{16U};
+  static constexpr auto const kEmpty = std::uint8_t{0x80U};
+
+  // Returns the index of key and whether it was inserted.
+  template <typename K>
+  std::pair<std::size_t, bool> insert(K&& key) {
+    if ((keys_.size() + 1U) * 8U > slots_.size() * 7U) {
+      grow();
+    }
+    auto const h = hash(key);
+    auto const tag = static_cast<std::uint8_t>(h >> 57U);
+    for (auto g = h & group_mask_;; g = (g + 1U) & group_mask_) {
+      auto const ctrl = &ctrl_[g * kGroupSize];
+      for (auto m = match(ctrl, tag); m != 0U; m &= m - 1U) {
+        auto const idx = slots_[g * kGroupSize + trailing_zeros(m)];
+        if (eq_(keys_[idx], key)) {
+          return {idx, false};
+        }
+      }
+      if (auto const empty = match(ctrl, kEmpty); empty != 0U) {
+        auto const slot = g * kGroupSize + trailing_zeros(empty);
+        ctrl_[slot] = tag;
+        slots_[slot] = keys_.size();
+        keys_.emplace_back(std::forward<K>(key));
+        return {keys_.size() - 1U, true};
+      }
+    }
+  }
+
+  std::size_t size() const { return keys_.size(); }
+
+  template <typename K>
+  std::uint64_t hash(K const& key) const {
+    // murmur3 finalizer: std::hash is the identity for integers.
+    auto h = static_cast<std::uint64_t>(hash_(key));
+    h ^= h >> 33U;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33U;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33U;
+    return h;
+  }
+
+  static unsigned match(std::uint8_t const* ctrl, std::uint8_t const tag) {
+#ifdef UTL_SIMD_SSE2
+    auto const group =
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(ctrl));
+    return static_cast<unsigned>(_mm_movemask_epi8(
+        _mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(tag)))));
+#else
+    auto m = 0U;
+    for (auto i = 0U; i != kGroupSize; ++i) {
+      m |= static_cast<unsigned>(ctrl[i] == tag) << i;
+    }
+    return m;
+#endif
+  }
+
+  void grow() {
+    auto const n_groups =
+        slots_.empty() ? std::size_t{1U} : 2U * slots_.size() / kGroupSize;
+    group_mask_ = n_groups - 1U;
+    ctrl_.assign(n_groups * kGroupSize, kEmpty);
+    slots_.resize(n_groups * kGroupSize);
+    for (auto idx = std::size_t{0U}; idx != keys_.size(); ++idx) {
+      auto const h = hash(keys_[idx]);
+      for (auto g = h & group_mask_;; g = (g + 1U) & group_mask_) {
+        if (auto const empty = match(&ctrl_[g * kGroupSize], kEmpty);
+            empty != 0U) {
+          auto const slot = g * kGroupSize + trailing_zeros(empty);
+          ctrl_[slot] = static_cast<std::uint8_t>(h >> 57U);
+          slots_[slot] = idx;
+          break;
+        }
+      }
+    }
+  }
+
+  std::vector<Key> keys_;
+  std::vector<std::uint8_t> ctrl_;
+  std::vector<std::size_t> slots_;
+  std::size_t group_mask_{0U};
+  Hash hash_;
+  Eq eq_;
+};
+
+}  // namespace utl
@@ -1,10 +1,15 @@
 #pragma once
 
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
+#include <limits>
 #include <string>
 
 #include "utl/parser/cstr.h"
+#include "utl/parser/fp_parser.h"
+#include "utl/parser/swar.h"
 #include "utl/verify.h"
 
 namespace utl {
@@ -14,10 +19,10 @@ inline bool parse_arg(
     cstr& s, IntType& arg,
     typename std::enable_if<std::is_integral<IntType>::value, IntType>::type
         default_value = 0) {
-  IntType sign = 1;
+  auto negative = false;
   if constexpr (std::is_signed_v<IntType>) {
     if (s && s[0] == '-') {
-      sign = -1;
+      negative = true;
       ++s;
     }
   }
@@ -26,71 +31,106 @@ inline bool parse_arg(
     ++s;
   }
 
-  arg = 0;
-  bool value_okay = false;
-  while (s) {
-    char c = *s.str;
-    if (c > '9' || c < '0') {
-      break;
-    }
-    arg = arg * 10 + static_cast<IntType>(c - '0');
-    value_okay = true;
-    ++s;
-  }
+  auto value = std::uint64_t{0U};
+  auto const digits_end = parse_digits(s.str, s.end(), value);
+  auto const value_okay = digits_end != s.str;
+  s += static_cast<std::size_t>(digits_end - s.str);
 
   if (!value_okay) {
     arg = default_value;
   } else {
-    arg *= sign;
+    arg = static_cast<IntType>(negative ? std::uint64_t{0U} - value : value);
   }
 
   return value_okay && s.empty();
 }
 
-template <typename T>
-inline bool parse_fp(cstr& s, T& v) {
-  if (!s) {
-    v = {};
-    return false;
+// Like parse_arg but fails (and saturates arg) if the value does not fit.
+template <typename IntType>
+inline bool parse_arg_checked(cstr& s, IntType& arg) {
+  static_assert(std::is_integral_v<IntType>);
+
+  auto negative = false;
+  if constexpr (std::is_signed_v<IntType>) {
+    if (s && s[0] == '-') {
+      negative = true;
+      ++s;
+    }
   }
 
-  auto sign = T{1.0};
-  if (*s.str == '-') {
-    sign = -1.0;
+  if (s && s[0] == '+') {
     ++s;
   }
 
-  int pre_point;
-  parse_arg(s, pre_point);
-  v = static_cast<T>(pre_point);
-  if (s.len == 0) {
-    v *= sign;
-    return true;
+  auto value = std::uint64_t{0U};
+  auto overflow = false;
+  auto const digits_end = parse_digits<true>(s.str, s.end(), value, &overflow);
+  auto const value_okay = digits_end != s.str;
+  s += static_cast<std::size_t>(digits_end - s.str);
+
+  using limits = std::numeric_limits<IntType>;
+  auto const max = static_cast<std::uint64_t>(limits::max());
+  if (negative) {
+    if (overflow || value > max + 1U) {
+      arg = limits::min();
+      return false;
+    }
+    arg = static_cast<IntType>(std::uint64_t{0U} - value);
+  } else {
+    if (overflow || value > max) {
+      arg = limits::max();
+      return false;
+    }
+    arg = static_cast<IntType>(value);
   }
 
-  if (*s.str != '.') {
-    v *= sign;
+  return value_okay && s.empty();
+}
+
+// Parses exactly N (1 <= N <= 16) digits without sign, e.g. N=6 for HHMMSS
+// or N=8 for YYYYMMDD. Leaves s unchanged if there are not N digits.
+template <std::size_t N, typename IntType>
+inline bool parse_fixed(cstr& s, IntType& arg) {
+  static_assert(N >= 1U && N <= 16U);
+  static_assert(std::is_integral_v<IntType>);
+
+  if (s.len < N) {
     return false;
   }
-  ++s;
-
-  auto is_good = true;
-  T multiplier = static_cast<T>(0.1);
-  while (s) {
-    char c = *s.str;
-    if (c > '9' || c < '0') {
-      is_good = false;
-      break;
+
+  if constexpr (kSwarDigits) {
+    constexpr auto const hi_digits = N > 8U ? N - 8U : 0U;
+    constexpr auto const lo_digits = N - hi_digits;
+
+    auto lo = std::uint64_t{0x3030303030303030ULL};
+    std::memcpy(reinterpret_cast<char*>(&lo) + (8U - lo_digits),
+                s.str + hi_digits, lo_digits);
+    if (!is_eight_digits(lo)) {
+      return false;
     }
-    v += multiplier * (c - '0');
-    multiplier *= static_cast<T>(0.1);
-    if (s) {
-      ++s;
+    auto value = std::uint64_t{parse_eight_digits(lo)};
+
+    if constexpr (hi_digits != 0U) {
+      auto hi = std::uint64_t{0x3030303030303030ULL};
+      std::memcpy(reinterpret_cast<char*>(&hi) + (8U - hi_digits), s.str,
+                  hi_digits);
+      if (!is_eight_digits(hi)) {
+        return false;
+      }
+      value += parse_eight_digits(hi) * std::uint64_t{100000000U};
+    }
+
+    arg = static_cast<IntType>(value);
+  } else {
+    auto value = std::uint64_t{0U};
+    if (parse_digits(s.str, s.str + N, value) != s.str + N) {
+      return false;
     }
+    arg = static_cast<IntType>(value);
   }
-  v *= sign;
 
-  return is_good;
+  s += N;
+  return true;
 }
 
 inline bool parse_arg(cstr& s, float& arg) { return parse_fp(s, arg); }
@@ -0,0 +1,459 @@
+#pragma once
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define UTL_IO_URING 1
+#endif
+#endif
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utl/parser/buffer.h"
+#include "utl/parser/cstr.h"
+#include "utl/parser/mmap_reader.h"
+#include "utl/verify.h"
+
+namespace utl {
+
+constexpr auto const kDefaultAsyncBlockSize = std::size_t{4U * 1024U * 1024U};
+constexpr auto const kDefaultAsyncQueueDepth = 3U;
+
+namespace detail {
+
+// Reads size bytes at offset unless the file ends before.
+inline std::size_t pread_full(int const fd, char* buf, std::size_t const size,
+                              std::size_t const offset) {
+  auto total = std::size_t{0U};
+  while (total != size) {
+    auto const n = ::pread(fd, buf + total, size - total,
+                           static_cast<off_t>(offset + total));
+    if (n == -1 && errno == EINTR) {
+      continue;
+    }
+    utl::verify(n != -1, "pread error: {}", std::strerror(errno));
+    if (n == 0) {
+      break;
+    }
+    total += static_cast<std::size_t>(n);
+  }
+  return total;
+}
+
+// Executes the reads of the slots. A slot has at most one read in flight.
+// wait(slot) collects the completion of that slot and throws if its read
+// failed; the failure of one slot does not affect the others.
+struct async_read_backend {
+  virtual ~async_read_backend() = default;
+  virtual void submit(unsigned slot, char* buf, std::size_t size,
+                      std::size_t offset) = 0;
+  virtual std::size_t wait(unsigned slot) = 0;
+};
+
+// Fallback: one thread executes the submitted reads with pread in order.
+struct pread_thread_backend final : public async_read_backend {
+  struct request {
+    unsigned slot_;
+    char* buf_;
+    std::size_t size_, offset_;
+  };
+
+  pread_thread_backend(int const fd, unsigned const depth)
+      : fd_{fd}, results_(depth), done_(depth), errors_(depth) {
+    thread_ = std::thread{[this]() { run(); }};
+  }
+
+  ~pread_thread_backend() override {
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      stop_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+  }
+
+  void submit(unsigned const slot, char* buf, std::size_t const size,
+              std::size_t const offset) override {
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      done_[slot] = false;
+      errors_[slot] = nullptr;
+      queue_.push_back({slot, buf, size, offset});
+    }
+    cv_.notify_all();
+  }
+
+  std::size_t wait(unsigned const slot) override {
+    std::unique_lock<std::mutex> lock{mutex_};
+    cv_.wait(lock, [&]() { return done_[slot]; });
+    if (errors_[slot] != nullptr) {
+      std::rethrow_exception(errors_[slot]);
+    }
+    return results_[slot];
+  }
+
+  void run() {
+    while (true) {
+      request r;
+      {
+        std::unique_lock<std::mutex> lock{mutex_};
+        cv_.wait(lock, [&]() { return stop_ || !queue_.empty(); });
+        if (stop_) {
+          return;
+        }
+        r = queue_.front();
+        queue_.erase(begin(queue_));
+      }
+
+      auto size = std::size_t{0U};
+      auto error = std::exception_ptr{};
+      try {
+        size = pread_full(fd_, r.buf_, r.size_, r.offset_);
+      } catch (...) {
+        error = std::current_exception();
+      }
+
+      {
+        std::lock_guard<std::mutex> lock{mutex_};
+        results_[r.slot_] = size;
+        done_[r.slot_] = true;
+        errors_[r.slot_] = error;
+      }
+      cv_.notify_all();
+    }
+  }
+
+  int fd_;
+  std::vector<std::size_t> results_;
+  std::vector<bool> done_;
+  std::vector<std::exception_ptr> errors_;
+  std::vector<request> queue_;
+  bool stop_{false};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::thread thread_;
+};
+
+#ifdef UTL_IO_URING
+
+// io_uring via raw system calls (no liburing dependency).
+// The submission and completion rings are only used by the owning thread.
+struct io_uring_backend final : public async_read_backend {
+  io_uring_backend(int const fd, unsigned const depth)
+      : fd_{fd},
+        iovecs_(depth),
+        results_(depth),
+        done_(depth),
+        errors_(depth) {
+    io_uring_params params{};
+    ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, depth, &params));
+    if (ring_fd_ < 0) {
+      return;
+    }
+
+    sq_size_ = params.sq_off.array + params.sq_entries * sizeof(std::uint32_t);
+    cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    auto const single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0U;
+    if (single_mmap) {
+      sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+    }
+
+    sq_ptr_ = mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+    cq_ptr_ = single_mmap ? sq_ptr_
+                          : mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE,
+                                 MAP_SHARED | MAP_POPULATE, ring_fd_,
+                                 IORING_OFF_CQ_RING);
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe*>(
+        mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES));
+    if (sq_ptr_ == MAP_FAILED || cq_ptr_ == MAP_FAILED ||
+        sqes_ == MAP_FAILED) {
+      release();
+      return;
+    }
+
+    auto const sq = static_cast<char*>(sq_ptr_);
+    sq_tail_ = reinterpret_cast<std::uint32_t*>(sq + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<std::uint32_t*>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<std::uint32_t*>(sq + params.sq_off.array);
+
+    auto const cq = static_cast<char*>(cq_ptr_);
+    cq_head_ = reinterpret_cast<std::uint32_t*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<std::uint32_t*>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<std::uint32_t*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+  }
+
+  ~io_uring_backend() override { release(); }
+
+  io_uring_backend(io_uring_backend const&) = delete;
+  io_uring_backend& operator=(io_uring_backend const&) = delete;
+
+  bool valid() const { return ring_fd_ >= 0; }
+
+  void release() {
+    if (sqes_ != nullptr && sqes_ != MAP_FAILED) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (cq_ptr_ != nullptr && cq_ptr_ != MAP_FAILED && cq_ptr_ != sq_ptr_) {
+      munmap(cq_ptr_, cq_size_);
+    }
+    if (sq_ptr_ != nullptr && sq_ptr_ != MAP_FAILED) {
+      munmap(sq_ptr_, sq_size_);
+    }
+    if (ring_fd_ >= 0) {
+      close(ring_fd_);
+    }
+    sqes_ = nullptr;
+    sq_ptr_ = cq_ptr_ = nullptr;
+    ring_fd_ = -1;
+  }
+
+  void submit(unsigned const slot, char* buf, std::size_t const size,
+              std::size_t const offset) override {
+    iovecs_[slot] = {buf, size};
+    done_[slot] = false;
+    errors_[slot] = 0;
+
+    auto const tail = *sq_tail_;
+    auto const idx = tail & sq_mask_;
+    auto& sqe = sqes_[idx];
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_READV;
+    sqe.fd = fd_;
+    sqe.addr = reinterpret_cast<std::uint64_t>(&iovecs_[slot]);
+    sqe.len = 1U;
+    sqe.off = offset;
+    sqe.user_data = slot;
+    sq_array_[idx] = idx;
+    __atomic_store_n(sq_tail_, tail + 1U, __ATOMIC_RELEASE);
+
+    while (syscall(__NR_io_uring_enter, ring_fd_, 1U, 0U, 0U, nullptr, 0U) ==
+           -1) {
+      utl::verify(errno == EINTR || errno == EAGAIN,
+                  "io_uring_enter error: {}", std::strerror(errno));
+    }
+  }
+
+  std::size_t wait(unsigned const slot) override {
+    while (!done_[slot]) {
+      auto head = *cq_head_;
+      if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+        auto const ret = syscall(__NR_io_uring_enter, ring_fd_, 0U, 1U,
+                                 IORING_ENTER_GETEVENTS, nullptr, 0U);
+        utl::verify(ret != -1 || errno == EINTR, "io_uring_enter error: {}",
+                    std::strerror(errno));
+        continue;
+      }
+
+      // Consume the entry before reporting an error: otherwise it would
+      // stay at the head and block the completions of all other slots.
+      auto const& cqe = cqes_[head & cq_mask_];
+      auto const s = static_cast<unsigned>(cqe.user_data);
+      results_[s] = cqe.res < 0 ? 0U : static_cast<std::size_t>(cqe.res);
+      errors_[s] = cqe.res < 0 ? -cqe.res : 0;
+      done_[s] = true;
+      __atomic_store_n(cq_head_, head + 1U, __ATOMIC_RELEASE);
+    }
+    utl::verify(errors_[slot] == 0, "io_uring read error: {}",
+                std::strerror(errors_[slot]));
+    return results_[slot];
+  }
+
+  int fd_;
+  int ring_fd_{-1};
+  void* sq_ptr_{nullptr};
+  void* cq_ptr_{nullptr};
+  io_uring_sqe* sqes_{nullptr};
+  std::size_t sq_size_{0U}, cq_size_{0U}, sqes_size_{0U};
+  std::uint32_t* sq_tail_{nullptr};
+  std::uint32_t* sq_array_{nullptr};
+  std::uint32_t sq_mask_{0U};
+  std::uint32_t* cq_head_{nullptr};
+  std::uint32_t* cq_tail_{nullptr};
+  std::uint32_t cq_mask_{0U};
+  io_uring_cqe* cqes_{nullptr};
+  std::vector<iovec> iovecs_;
+  std::vector<std::size_t> results_;
+  std::vector<bool> done_;
+  std::vector<int> errors_;
+};
+
+#endif
+
+}  // namespace detail
+
+// Reads a file with up to `depth` block reads in flight (io_uring where
+// available, otherwise a pread thread), so parsing one block overlaps with
+// loading the next ones. POSIX only.
+struct async_reader {
+  enum class backend { kAuto, kIoUring, kPreadThread };
+
+  explicit async_reader(char const* path,
+                        std::size_t const block_size = kDefaultAsyncBlockSize,
+                        unsigned const depth = kDefaultAsyncQueueDepth,
+                        backend const b = backend::kAuto)
+      : f_{path},
+        size_{f_.size_},
+        block_size_{std::max(block_size, std::size_t{1U})},
+        depth_{std::max(depth, 1U)},
+        buf_(block_size_ * depth_) {
+#ifdef UTL_IO_URING
+    if (b != backend::kPreadThread) {
+      auto uring = std::make_unique<detail::io_uring_backend>(f_.fd_, depth_);
+      if (uring->valid()) {
+        backend_ = std::move(uring);
+      }
+    }
+#endif
+    utl::verify(b != backend::kIoUring || backend_ != nullptr,
+                "io_uring not available");
+    if (backend_ == nullptr) {
+      backend_ =
+          std::make_unique<detail::pread_thread_backend>(f_.fd_, depth_);
+    }
+
+    for (auto slot = 0U; slot != depth_ && submitted_ < size_; ++slot) {
+      submit(slot);
+    }
+  }
+
+  async_reader(async_reader const&) = delete;
+  async_reader& operator=(async_reader const&) = delete;
+  async_reader(async_reader&&) = default;
+  async_reader& operator=(async_reader&&) = delete;
+
+  ~async_reader() {
+    if (backend_ == nullptr) {
+      return;
+    }
+
+    // Outstanding reads write into buf_: wait for them before releasing it.
+    // A failed read only affects its own slot, so every slot is collected.
+    for (auto slot = 0U; slot != depth_; ++slot) {
+      if (in_flight_[slot]) {
+        try {
+          backend_->wait(slot);
+        } catch (...) {
+        }
+      }
+    }
+    backend_.reset();
+  }
+
+  // Returns the next block of the file. Valid until the next call.
+  // Empty at the end of the file.
+  cstr next_block() {
+    if (current_slot_ != kNoSlot && submitted_ < size_) {
+      submit(current_slot_);
+    }
+
+    if (consumed_ >= size_) {
+      current_slot_ = kNoSlot;
+      return {};
+    }
+
+    auto const slot = static_cast<unsigned>((consumed_ / block_size_) % depth_);
+    auto const expected = std::min(block_size_, size_ - consumed_);
+    auto const block = slot_ptr(slot);
+    auto n = backend_->wait(slot);
+    in_flight_[slot] = false;
+    if (n < expected) {
+      // Short read: fetch the rest synchronously.
+      n += detail::pread_full(f_.fd_, block + n, expected - n, consumed_ + n);
+    }
+    consumed_ += expected;
+    current_slot_ = slot;
+    return {block, n};
+  }
+
+  // Same contract as buf_reader::read_line(): valid until the next call.
+  cstr read_line() {
+    if (line_from_carry_) {
+      carry_.clear();
+      line_from_carry_ = false;
+    }
+
+    while (true) {
+      auto const nl =
+          block_.len == 0U ? nullptr
+                           : static_cast<char const*>(
+                                 std::memchr(block_.str, '\n', block_.len));
+      if (nl != nullptr) {
+        auto line = cstr{block_.str, nl};
+        block_ = cstr{nl + 1, block_.end()};
+        if (!carry_.empty()) {
+          carry_.append(line.str, line.len);
+          line = cstr{carry_.data(), carry_.size()};
+          line_from_carry_ = true;
+        }
+        return line;
+      }
+
+      if (block_.len != 0U) {
+        carry_.append(block_.str, block_.len);
+      }
+      block_ = next_block();
+      if (block_.len == 0U) {
+        if (carry_.empty()) {
+          return {nullptr, 0};
+        }
+        line_from_carry_ = true;
+        return {carry_.data(), carry_.size()};
+      }
+    }
+  }
+
+  float progress() const {
+    return size_ == 0U ? 1.0F
+                       : static_cast<float>(consumed_) /
+                             static_cast<float>(size_);
+  }
+
+  static constexpr auto const kNoSlot = ~0U;
+
+  char* slot_ptr(unsigned const slot) {
+    return reinterpret_cast<char*>(buf_.data()) + slot * block_size_;
+  }
+
+  void submit(unsigned const slot) {
+    auto const size = std::min(block_size_, size_ - submitted_);
+    backend_->submit(slot, slot_ptr(slot), size, submitted_);
+    in_flight_[slot] = true;
+    submitted_ += size;
+  }
+
+  mmap_reader::file f_;
+  std::size_t size_;
+  std::size_t block_size_;
+  unsigned depth_;
+  buffer buf_;
+  std::unique_ptr<detail::async_read_backend> backend_;
+  std::vector<bool> in_flight_ = std::vector<bool>(depth_);
+  std::size_t submitted_{0U}, consumed_{0U};
+  unsigned current_slot_{kNoSlot};
+
+  cstr block_;
+  std::string carry_;
+  bool line_from_carry_{false};
+};
+
+}  // namespace utl
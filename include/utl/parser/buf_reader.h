@@ -51,7 +51,7 @@ struct buf_reader {
 };
 
 template <typename ProgressConsumer>
-buf_reader(ProgressConsumer&&) -> buf_reader<ProgressConsumer>;
+buf_reader(cstr, ProgressConsumer&&) -> buf_reader<ProgressConsumer>;
 
 template <typename ProgressConsumer = noop_progress_consumer>
 buf_reader<ProgressConsumer> make_buf_reader(
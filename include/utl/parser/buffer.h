@@ -2,17 +2,102 @@
 
 #include <cstdlib>
 #include <cstring>
+
+#include <algorithm>
+#include <map>
+#include <mutex>
 #include <new>
+#include <utility>
 
 #include "utl/verify.h"
 
 namespace utl {
 
+// Buffer memory is aligned to kBufferAlignment and followed by at least
+// kBufferPadding zero bytes, so vectorized kernels may read past the end.
+constexpr auto const kBufferAlignment = std::size_t{64U};
+constexpr auto const kBufferPadding = std::size_t{64U};
+
+namespace detail {
+
+inline void* alloc_aligned(std::size_t const capacity) {
+#ifdef _MSC_VER
+  return _aligned_malloc(capacity, kBufferAlignment);
+#else
+  void* ptr = nullptr;
+  return posix_memalign(&ptr, kBufferAlignment, capacity) == 0 ? ptr
+                                                               : nullptr;
+#endif
+}
+
+inline void free_aligned(void* ptr) {
+#ifdef _MSC_VER
+  _aligned_free(ptr);
+#else
+  std::free(ptr);
+#endif
+}
+
+}  // namespace detail
+
+struct buffer;
+
+// Thread safe cache of buffer memory. Buffers taken from the pool return
+// their memory on destruction, so the pool has to outlive them.
+struct buffer_pool {
+  explicit buffer_pool(std::size_t const max_cached = 16U)
+      : max_cached_{max_cached} {}
+
+  buffer_pool(buffer_pool const&) = delete;
+  buffer_pool& operator=(buffer_pool const&) = delete;
+
+  ~buffer_pool() {
+    for (auto const& [capacity, ptr] : free_) {
+      detail::free_aligned(ptr);
+    }
+  }
+
+  buffer get(std::size_t size);
+
+  // Smallest cached block that fits, as long as it is at most twice as
+  // large as needed. Returns {nullptr, 0} if there is none.
+  std::pair<void*, std::size_t> take(std::size_t const capacity) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto const it = free_.lower_bound(capacity);
+    if (it == end(free_) || it->first > 2U * capacity) {
+      return {nullptr, 0U};
+    }
+    auto const block = std::pair<void*, std::size_t>{it->second, it->first};
+    free_.erase(it);
+    return block;
+  }
+
+  void put(void* ptr, std::size_t const capacity) {
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      if (free_.size() < max_cached_) {
+        free_.emplace(capacity, ptr);
+        return;
+      }
+    }
+    detail::free_aligned(ptr);
+  }
+
+  std::size_t cached() const {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return free_.size();
+  }
+
+  std::size_t max_cached_;
+  mutable std::mutex mutex_;
+  std::multimap<std::size_t, void*> free_;
+};
+
 struct buffer final {
   buffer() : buf_(nullptr), size_(0) {}
 
-  explicit buffer(std::size_t size) : buf_(malloc(size)), size_(size) {
-    verify(buf_ != nullptr, "buffer initialization failed");
+  explicit buffer(std::size_t size) : buf_(nullptr), size_(0) {
+    resize(size);
   }
 
   explicit buffer(char const* str) : buffer(std::strlen(str)) {
@@ -23,28 +108,38 @@ struct buffer final {
     std::memcpy(buf_, str, size_);
   }
 
-  ~buffer() {
-    std::free(buf_);
-    buf_ = nullptr;
-  }
+  ~buffer() { release(); }
 
   buffer(buffer const&) = delete;
   buffer& operator=(buffer const&) = delete;
 
-  buffer(buffer&& o) noexcept : buf_(o.buf_), size_(o.size_) {
+  buffer(buffer&& o) noexcept
+      : buf_(o.buf_), size_(o.size_), capacity_(o.capacity_), pool_(o.pool_) {
     o.buf_ = nullptr;
     o.size_ = 0;
+    o.capacity_ = 0;
+    o.pool_ = nullptr;
   }
 
   buffer& operator=(buffer&& o) noexcept {
-    buf_ = o.buf_;
-    size_ = o.size_;
-    o.buf_ = nullptr;
-    o.size_ = 0;
+    if (this != &o) {
+      release();
+      buf_ = o.buf_;
+      size_ = o.size_;
+      capacity_ = o.capacity_;
+      pool_ = o.pool_;
+      o.buf_ = nullptr;
+      o.size_ = 0;
+      o.capacity_ = 0;
+      o.pool_ = nullptr;
+    }
     return *this;
   }
 
   inline std::size_t size() const { return size_; }
+  inline std::size_t capacity() const {
+    return capacity_ == 0U ? 0U : capacity_ - kBufferPadding;
+  }
 
   inline unsigned char* data() { return static_cast<unsigned char*>(buf_); }
   inline unsigned char const* data() const {
@@ -55,16 +150,58 @@ struct buffer final {
   inline unsigned char* end() { return data() + size_; }
 
   inline void resize(std::size_t new_size) {
-    if (void* tmp = std::realloc(buf_, new_size)) {
-      buf_ = tmp;
-      size_ = new_size;
-    } else {
-      throw std::bad_alloc();
+    if (new_size + kBufferPadding > capacity_) {
+      auto const new_capacity =
+          round_up(std::max(new_size, capacity_ + capacity_ / 2U)) +
+          kBufferPadding;
+      auto const ptr = detail::alloc_aligned(new_capacity);
+      if (ptr == nullptr) {
+        throw std::bad_alloc();
+      }
+      if (buf_ != nullptr) {
+        std::memcpy(ptr, buf_, std::min(size_, new_size));
+      }
+      release();
+      buf_ = ptr;
+      capacity_ = new_capacity;
+    }
+    size_ = new_size;
+    std::memset(data() + size_, 0, kBufferPadding);
+  }
+
+  static std::size_t round_up(std::size_t const n) {
+    return (n + kBufferAlignment - 1U) / kBufferAlignment * kBufferAlignment;
+  }
+
+  void release() {
+    if (buf_ != nullptr) {
+      if (pool_ != nullptr) {
+        pool_->put(buf_, capacity_);
+      } else {
+        detail::free_aligned(buf_);
+      }
     }
+    buf_ = nullptr;
+    size_ = 0;
+    capacity_ = 0;
   }
 
   void* buf_;
   std::size_t size_;
+  std::size_t capacity_{0U};  // including the padding
+  buffer_pool* pool_{nullptr};
 };
 
+inline buffer buffer_pool::get(std::size_t const size) {
+  auto b = buffer{};
+  b.pool_ = this;
+  auto const [ptr, capacity] = take(buffer::round_up(size) + kBufferPadding);
+  if (ptr != nullptr) {
+    b.buf_ = ptr;
+    b.capacity_ = capacity;
+  }
+  b.resize(size);
+  return b;
+}
+
 }  // namespace utl
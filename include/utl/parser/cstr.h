@@ -9,6 +9,9 @@
 #include <string>
 #include <string_view>
 
+#include "utl/parser/simd_scanner.h"
+#include "utl/parser/string_algorithms.h"
+
 namespace utl {
 
 struct size {
@@ -57,7 +60,7 @@ struct cstr {
     } else if (len == 0) {
       return true;
     } else {
-      return strncmp(str, s.str, len) == 0;
+      return std::memcmp(str, s.str, len) == 0;
     }
   }
   bool operator!=(cstr const& s) const { return !operator==(s); }
@@ -91,41 +94,37 @@ struct cstr {
                                        : substr(f.from, size(f.size));
   }
   bool contains(cstr needle) const {
-    return view().find(needle.view()) != std::string_view::npos;
+    return find_substr(str, len, needle.str, needle.len) != kStringNotFound;
   }
   bool starts_with(cstr prefix) const {
-    if (len < prefix.len) {
-      return false;
-    }
-    return substr(0, size(prefix.len)) == prefix;
+    return len >= prefix.len &&
+           (prefix.len == 0 || std::memcmp(str, prefix.str, prefix.len) == 0);
   }
-  static bool is_space(char const c) { return c == ' ' || c == '\n'; }
+  bool ends_with(cstr suffix) const {
+    return len >= suffix.len &&
+           (suffix.len == 0 ||
+            std::memcmp(str + len - suffix.len, suffix.str, suffix.len) == 0);
+  }
+  bool equals_ignore_case(cstr const& s) const {
+    return len == s.len &&
+           (len == 0 || utl::equals_ignore_case(str, s.str, len));
+  }
+  static bool is_space(char const c) { return is_space_char(c); }
   cstr skip_whitespace_front() const {
-    auto copy = (*this);
-    while (copy.len != 0 && is_space(copy[0])) {
-      ++copy;
-    }
-    return copy;
+    auto const n = len == 0 ? 0U : find_first_non_space(str, len);
+    return {str + n, len - n};
   }
   cstr skip_whitespace_back() const {
-    auto copy = (*this);
-    while (copy.len != 0 && is_space(copy.str[copy.len - 1])) {
-      --copy.len;
-    }
-    return copy;
+    return {str, len == 0 ? 0U : find_last_non_space(str, len)};
   }
   cstr trim() const { return skip_whitespace_front().skip_whitespace_back(); }
   bool empty() const { return len == 0; }
   size_t length() const { return len; }
   char const* c_str() const { return str; }
   char const* data() const { return str; }
-  size_t substr_offset(cstr needle) {
-    for (size_t i = 0; i < len; ++i) {
-      if (substr(i).starts_with(needle)) {
-        return i;
-      }
-    }
-    return std::numeric_limits<size_t>::max();
+  size_t substr_offset(cstr needle) const {
+    return len == 0 ? kStringNotFound
+                    : find_substr(str, len, needle.str, needle.len);
   }
   std::string to_str() const { return std::string(str, len); }
   std::string_view view() const { return {str, len}; }
@@ -157,30 +156,26 @@ enum class continue_t : std::uint8_t { kContinue, kBreak };
 template <typename Function>
 auto for_each_token(cstr s, char separator, Function&& f)
     -> std::enable_if_t<std::is_same_v<decltype(f(cstr{})), void>> {
-  while (s.len > 0) {
-    cstr token = get_until(s, separator);
-    f(token);
-    s += token.len;
-    // skip separator
-    if (s.len != 0) {
-      ++s;
-    }
+  auto const last = s.end();
+  auto scanner = block_scanner<1U>{s.str, s.len, {separator}};
+  for (auto it = s.begin(); it != last;) {
+    auto const token_end = scanner.next();
+    f(cstr{it, token_end});
+    it = (token_end == last) ? last : token_end + 1;  // skip separator
   }
 }
 
 template <typename Function>
 auto for_each_token(cstr s, char separator, Function&& f)
     -> std::enable_if_t<std::is_same_v<decltype(f(cstr{})), continue_t>> {
-  while (s.len > 0) {
-    cstr token = get_until(s, separator);
-    if (f(token) == continue_t::kBreak) {
+  auto const last = s.end();
+  auto scanner = block_scanner<1U>{s.str, s.len, {separator}};
+  for (auto it = s.begin(); it != last;) {
+    auto const token_end = scanner.next();
+    if (f(cstr{it, token_end}) == continue_t::kBreak) {
       break;
     }
-    s += token.len;
-    // skip separator
-    if (s.len != 0) {
-      ++s;
-    }
+    it = (token_end == last) ? last : token_end + 1;  // skip separator
   }
 }
 
@@ -193,7 +188,9 @@ struct line_iterator {
   using const_reference = cstr const&;
 
   line_iterator() = default;
-  explicit line_iterator(cstr s) : s_{s} { ++*this; }
+  explicit line_iterator(cstr s) : s_{s}, newlines_{s.str, s.len, {'\n'}} {
+    ++*this;
+  }
 
   explicit operator bool() const { return s_.valid(); }
 
@@ -209,7 +206,7 @@ struct line_iterator {
     return *this;
   }
   line_iterator& operator++() {
-    line_ = get_until(s_, '\n');
+    line_ = cstr{s_.str, newlines_.next()};
     s_ += line_.len;
     if (s_.len != 0) {
       ++s_;  // skip separator
@@ -237,6 +234,7 @@ struct line_iterator {
 
   cstr s_;
   cstr line_;
+  block_scanner<1U> newlines_;
 };
 
 struct lines {
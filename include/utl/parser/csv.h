@@ -1,9 +1,12 @@
 #pragma once
 
+#include <cstring>
+
 #include <algorithm>
 #include <array>
 #include <iterator>
 #include <limits>
+#include <string>
 #include <tuple>
 #include <vector>
 
@@ -53,6 +56,26 @@ inline void parse_column(cstr& s, T& arg) {
                                             adjust_for_quote + adjust_for_cr));
 }
 
+// Cells returned by parse_column keep the doubled quotes ("") of quoted
+// cells. Opt-in inverse of csv_writer's escaping for callers that need the
+// original string.
+inline std::string unescape_csv(cstr const s) {
+  auto const quote =
+      s.len == 0U ? nullptr
+                  : static_cast<char const*>(std::memchr(s.str, '"', s.len));
+  if (quote == nullptr) {
+    return {s.str, s.len};
+  }
+  auto out = std::string{s.str, quote};
+  for (auto p = quote, end = s.str + s.len; p != end; ++p) {
+    out.push_back(*p);
+    if (*p == '"' && p + 1 != end && p[1] == '"') {
+      ++p;
+    }
+  }
+  return out;
+}
+
 template <typename IntType,
           std::enable_if_t<std::is_integral<IntType>::value, int> = 0>
 inline void parse_value(cstr& s, IntType& arg) {
@@ -101,6 +124,7 @@ void read(std::vector<std::tuple<Args...>>& v,
 
 typedef uint8_t column_idx_t;
 constexpr column_idx_t NO_COLUMN_IDX = std::numeric_limits<column_idx_t>::max();
+// Column limit of the tuple based read() API (csv_range has none).
 constexpr column_idx_t MAX_COLUMNS = 32;
 
 template <typename Tuple, char Separator = ','>
@@ -109,7 +133,8 @@ std::array<column_idx_t, MAX_COLUMNS> read_header(
   std::array<column_idx_t, MAX_COLUMNS> column_map;
   std::fill(std::begin(column_map), std::end(column_map), NO_COLUMN_IDX);
 
-  for (column_idx_t column = 0; s && *s.str != '\r' && *s.str != '\n';
+  for (column_idx_t column = 0;
+       column < MAX_COLUMNS && s && *s.str != '\r' && *s.str != '\n';
        ++column, ++s) {
     cstr header;
     parse_column<cstr, Separator>(s, header);
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "utl/clear_t.h"
+#include "utl/parser/csv_range.h"
+
+#include "cista/reflection/to_tuple.h"
+
+namespace utl {
+
+template <typename FieldRefs>
+struct column_vectors;
+
+template <typename... Fields>
+struct column_vectors<std::tuple<Fields&...>> {
+  using type = std::tuple<
+      std::vector<clear_t<decltype(std::declval<Fields&>().val())>>...>;
+};
+
+// Struct of arrays: one contiguous vector per csv_col field of T.
+template <typename T>
+struct csv_column_store {
+  using columns_t = typename column_vectors<decltype(cista::to_tuple(
+      std::declval<T&>()))>::type;
+
+  static constexpr auto const kColumns = std::tuple_size_v<columns_t>;
+
+  template <std::size_t I>
+  auto& get() {
+    return std::get<I>(columns_);
+  }
+
+  template <std::size_t I>
+  auto const& get() const {
+    return std::get<I>(columns_);
+  }
+
+  std::size_t size() const {
+    if constexpr (kColumns == 0U) {
+      return 0U;
+    } else {
+      return std::get<0>(columns_).size();
+    }
+  }
+
+  bool empty() const { return size() == 0U; }
+
+  void append(csv_cells<T>& row) {
+    append(row, std::make_index_sequence<kColumns>());
+  }
+
+  template <std::size_t... I>
+  void append(csv_cells<T>& row, std::index_sequence<I...>) {
+    (append_value(row[I], std::get<I>(columns_)), ...);
+  }
+
+  template <typename Vec>
+  static void append_value(cstr& s, Vec& column) {
+    typename Vec::value_type value{};
+    if (s) {
+      parse_arg(s, value);
+    }
+    column.emplace_back(std::move(value));
+  }
+
+  columns_t columns_;
+};
+
+template <typename T, char Separator = ',', typename Mode = scalar>
+struct csv_columns_t {
+  template <typename LineRange>
+  friend csv_column_store<T> operator|(LineRange&& r, csv_columns_t&&) {
+    auto const headers_permutation = read_header<T, Separator>(r.begin());
+    auto splitter = typename Mode::template row_splitter<Separator>{};
+
+    csv_column_store<T> store;
+    cstr s;
+    r.next(s);
+    while (r.valid(s)) {
+      csv_cells<T> row;
+      splitter.split(s, headers_permutation, row);
+      store.append(row);
+      r.next(s);
+    }
+    return store;
+  }
+};
+
+template <typename T, char Separator = ',', typename Mode = scalar>
+inline csv_columns_t<T, Separator, Mode> csv_columns() {
+  return {};
+}
+
+}  // namespace utl
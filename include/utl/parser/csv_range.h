@@ -1,15 +1,25 @@
 #pragma once
 
+#include <cstdint>
+
+#include <algorithm>
 #include <array>
 #include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "utl/clear_t.h"
 #include "utl/const_str.h"
 #include "utl/parser/arg_parser.h"
 #include "utl/parser/csv.h"
+#include "utl/parser/structural_index.h"
 #include "utl/pipes/all.h"
 #include "utl/pipes/is_range.h"
 
 #include "cista/reflection/for_each_field.h"
+#include "cista/reflection/to_tuple.h"
 
 namespace utl {
 
@@ -19,6 +29,16 @@ struct csv_col_name {
 };
 #define UTL_NAME(str) utl::csv_col_name<STRING_LITERAL(str)>
 
+// Additional header name that maps to the same column.
+template <char const* str>
+struct csv_col_alias {
+  static constexpr auto const alias_ = str;
+};
+#define UTL_ALIAS(str) utl::csv_col_alias<STRING_LITERAL(str)>
+
+// Header names of this column are matched ignoring ASCII case.
+struct csv_ignore_case {};
+
 template <typename T, typename... Tags>
 struct csv_col : Tags... {
   csv_col() = default;
@@ -36,71 +56,336 @@ constexpr auto get_name(T) {
   return T::name_;
 }
 
+// Field index of T for each column of the file (NO_COLUMN_IDX if the column
+// is not mapped). Trailing unmapped columns are dropped, so the size is the
+// number of columns a row has to be split into.
+using csv_permutation = std::vector<column_idx_t>;
+
+template <typename T>
+constexpr auto const kCsvFields =
+    std::tuple_size_v<decltype(cista::to_tuple(std::declval<T&>()))>;
+
+template <typename T>
+using csv_cells = std::array<cstr, kCsvFields<T>>;
+
+namespace detail {
+
+struct csv_header_name {
+  char const* name_{nullptr};
+  column_idx_t field_{NO_COLUMN_IDX};
+  bool ignore_case_{false};
+};
+
+template <typename Tag>
+struct csv_tag_name : std::false_type {
+  static constexpr char const* name_ = nullptr;
+};
+
+template <char const* str>
+struct csv_tag_name<csv_col_name<str>> : std::true_type {
+  static constexpr char const* name_ = str;
+};
+
+template <char const* str>
+struct csv_tag_name<csv_col_alias<str>> : std::true_type {
+  static constexpr char const* name_ = str;
+};
+
+template <typename Col>
+struct csv_col_names;
+
+template <typename T, typename... Tags>
+struct csv_col_names<csv_col<T, Tags...>> {
+  static constexpr auto const kCount =
+      ((csv_tag_name<Tags>::value ? 1U : 0U) + ... + 0U);
+  static constexpr auto const kIgnoreCase =
+      (std::is_same_v<Tags, csv_ignore_case> || ...);
+
+  template <std::size_t N>
+  static constexpr void collect(std::array<csv_header_name, N>& names,
+                                std::size_t& pos, column_idx_t const field) {
+    ((csv_tag_name<Tags>::value
+          ? (names[pos++] = {csv_tag_name<Tags>::name_, field, kIgnoreCase},
+             0)
+          : 0),
+     ...);
+  }
+};
+
+template <typename... Cols, std::size_t... I>
+constexpr auto collect_csv_header_names(std::tuple<Cols&...>*,
+                                        std::index_sequence<I...>) {
+  std::array<csv_header_name, (csv_col_names<clear_t<Cols>>::kCount + ... +
+                               0U)>
+      names{};
+  auto pos = std::size_t{0U};
+  (csv_col_names<clear_t<Cols>>::collect(names, pos,
+                                         static_cast<column_idx_t>(I)),
+   ...);
+  return names;
+}
+
+// All header names (UTL_NAME and UTL_ALIAS) of the fields of T.
+template <typename T>
+constexpr auto const kCsvHeaderNames = collect_csv_header_names(
+    static_cast<decltype(cista::to_tuple(std::declval<T&>()))*>(nullptr),
+    std::make_index_sequence<kCsvFields<T>>());
+
+constexpr char fold_case(char const c) {
+  return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// FNV-1a with a final mix. Case folded for csv_ignore_case names.
+constexpr std::uint32_t csv_header_hash(char const* s, std::size_t const len,
+                                        bool const fold) {
+  auto h = std::uint32_t{2166136261U};
+  for (auto i = std::size_t{0U}; i != len; ++i) {
+    h ^= static_cast<unsigned char>(fold ? fold_case(s[i]) : s[i]);
+    h *= 16777619U;
+  }
+  h ^= h >> 16U;
+  h *= 0x85EBCA6BU;
+  h ^= h >> 13U;
+  return h;
+}
+
+constexpr std::size_t c_str_len(char const* s) {
+  auto len = std::size_t{0U};
+  while (s[len] != '\0') {
+    ++len;
+  }
+  return len;
+}
+
+// Open addressing (linear probing) table over the header names, built at
+// compile time with a load factor of at most 1/2. Case sensitive names are
+// stored under their hash, csv_ignore_case names under the case folded one.
+// A lookup probes both chains (if the struct has both kinds of names) and
+// returns the match of the first name in field order, like a linear scan.
+template <std::size_t N>
+struct csv_header_table {
+  static constexpr auto const kEmpty = std::uint16_t{0xFFFFU};
+
+  static constexpr std::size_t table_size() {
+    auto size = std::size_t{2U};
+    while (size < 2U * N) {
+      size *= 2U;
+    }
+    return size;
+  }
+
+  static constexpr auto const kSize = table_size();
+
+  static_assert(N < kEmpty, "too many csv header names");
+
+  constexpr explicit csv_header_table(
+      std::array<csv_header_name, N> const& names)
+      : names_{names} {
+    for (auto& slot : slots_) {
+      slot = kEmpty;
+    }
+    for (auto i = std::size_t{0U}; i != N; ++i) {
+      auto const name = names_[i].name_;
+      auto const ignore_case = names_[i].ignore_case_;
+      (ignore_case ? has_folded_ : has_exact_) = true;
+      auto pos = csv_header_hash(name, c_str_len(name), ignore_case) &
+                 (kSize - 1U);
+      while (slots_[pos] != kEmpty) {
+        pos = (pos + 1U) & (kSize - 1U);
+      }
+      slots_[pos] = static_cast<std::uint16_t>(i);
+    }
+  }
+
+  column_idx_t find(cstr const header) const {
+    auto best = std::size_t{N};
+    if (has_exact_) {
+      best = std::min(best, probe(header, false));
+    }
+    if (has_folded_) {
+      best = std::min(best, probe(header, true));
+    }
+    return best == N ? NO_COLUMN_IDX : names_[best].field_;
+  }
+
+  // Smallest index of a matching name of the given kind on the probe
+  // chain, N if there is none.
+  std::size_t probe(cstr const header, bool const ignore_case) const {
+    auto best = std::size_t{N};
+    for (auto pos = csv_header_hash(header.str, header.len, ignore_case) &
+                    (kSize - 1U);
+         slots_[pos] != kEmpty; pos = (pos + 1U) & (kSize - 1U)) {
+      auto const idx = std::size_t{slots_[pos]};
+      if (idx < best && names_[idx].ignore_case_ == ignore_case &&
+          matches(names_[idx], header)) {
+        best = idx;
+      }
+    }
+    return best;
+  }
+
+  static bool matches(csv_header_name const& candidate, cstr const header) {
+    auto const name = cstr{candidate.name_};
+    if (name.len != header.len) {
+      return false;
+    }
+    for (auto i = std::size_t{0U}; i != name.len; ++i) {
+      if (candidate.ignore_case_ ? fold_case(name[i]) != fold_case(header[i])
+                                 : name[i] != header[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::array<csv_header_name, N> names_{};
+  std::array<std::uint16_t, kSize> slots_{};
+  bool has_exact_{false};
+  bool has_folded_{false};
+};
+
+template <typename T>
+constexpr auto const kCsvHeaderTable =
+    csv_header_table<kCsvHeaderNames<T>.size()>{kCsvHeaderNames<T>};
+
+}  // namespace detail
+
 template <typename T, char Separator = ','>
-std::array<column_idx_t, MAX_COLUMNS> read_header(cstr s) {
+csv_permutation read_header(cstr s) {
+  static_assert(kCsvFields<T> < NO_COLUMN_IDX);
+
+  constexpr auto const& table = detail::kCsvHeaderTable<T>;
+
   if (s.starts_with("\xEF\xBB\xBF")) {
     // skip utf-8 byte order mark (otherwise the first column is ignored)
     s = s.substr(3);
   }
 
-  std::array<column_idx_t, MAX_COLUMNS> column_map;
-  column_map.fill(NO_COLUMN_IDX);
-
-  for (column_idx_t column = 0; s; ++column) {
+  csv_permutation column_map;
+  while (s) {
     cstr header;
     parse_column<cstr, Separator>(s, header);
 
-    column_map[column] = NO_COLUMN_IDX;
-    column_idx_t c = 0u;
-    cista::for_each_field<T>([&](auto&& f) {
-      if (header == get_name(f)) {
-        column_map[column] = c;
-        return;
-      }
-      ++c;
-    });
+    column_map.emplace_back(table.find(header));
 
     if (s) {
       ++s;
     }
   }
 
+  while (!column_map.empty() && column_map.back() == NO_COLUMN_IDX) {
+    column_map.pop_back();
+  }
+
   return column_map;
 }
 
-template <typename T, typename LineRange, char Separator = ','>
-struct csv_range : public LineRange {
-  using result_t = T;
+// Splits the row byte by byte with parse_column.
+// Stops after the last mapped column.
+struct scalar {
+  template <char Separator>
+  struct row_splitter {
+    template <std::size_t N>
+    void split(cstr s, csv_permutation const& permutation,
+               std::array<cstr, N>& row) {
+      for (auto const field : permutation) {
+        if (!s) {
+          break;
+        }
 
-  csv_range(LineRange&& r)
-      : LineRange{std::forward<LineRange>(r)},
-        headers_permutation_{read_header<T, Separator>(LineRange::begin())} {}
+        cstr column_content;
+        parse_column<cstr, Separator>(s, column_content);
 
-  inline T read_row(cstr s) {
-    std::array<cstr, MAX_COLUMNS> row;
-    for (column_idx_t i = 0; i < MAX_COLUMNS && s; ++i) {
-      cstr column_content;
-      parse_column<cstr, Separator>(s, column_content);
+        if (field != NO_COLUMN_IDX) {
+          row[field] = column_content;
+        }
 
-      if (headers_permutation_[i] != NO_COLUMN_IDX) {
-        row[headers_permutation_[i]] = column_content;
+        if (s) {
+          ++s;
+        }
       }
+    }
+  };
+};
 
-      if (s) {
-        ++s;
-      }
+// Splits the row with a vectorized structural index (see structural_index.h).
+// Stops scanning after the block containing the last mapped column.
+struct simd {
+  template <char Separator>
+  struct row_splitter {
+    template <std::size_t N>
+    void split(cstr s, csv_permutation const& permutation,
+               std::array<cstr, N>& row) {
+      index_.build(s, permutation.size());
+      index_.for_each_field([&](std::size_t const i, cstr const field) {
+        if (i < permutation.size() && permutation[i] != NO_COLUMN_IDX) {
+          row[permutation[i]] = field;
+        }
+      });
+    }
+
+    structural_index<Separator> index_;
+  };
+};
+
+// Value type of the I-th csv_col field of T.
+template <typename T, std::size_t I>
+using csv_field_t = clear_t<decltype(
+    std::get<I>(cista::to_tuple(std::declval<T&>())).val())>;
+
+// Split but unparsed row: the cells point into the line buffer and are
+// converted only when accessed. Cells are in field order of T.
+template <typename T>
+struct csv_row {
+  template <std::size_t I>
+  cstr raw() const {
+    return cells_[I];
+  }
+
+  template <std::size_t I>
+  csv_field_t<T, I> get() const {
+    auto value = csv_field_t<T, I>{};
+    if (auto s = cells_[I]; s) {
+      parse_arg(s, value);
     }
+    return value;
+  }
 
+  T materialize() const {
     T t{};
     cista::for_each_field(t, [&, i = 0u](auto& f) mutable {
-      if (row[i]) {
-        parse_arg(row[i], f.val());
+      if (auto s = cells_[i]; s) {
+        parse_arg(s, f.val());
       }
       ++i;
     });
     return t;
   }
 
+  csv_cells<T> cells_;
+};
+
+template <typename T, typename RowSplitter>
+T decode_row(cstr s, csv_permutation const& headers_permutation,
+             RowSplitter& splitter) {
+  csv_row<T> row;
+  splitter.split(s, headers_permutation, row.cells_);
+  return row.materialize();
+}
+
+template <typename T, typename LineRange, char Separator = ',',
+          typename Mode = scalar>
+struct csv_range : public LineRange {
+  using result_t = T;
+
+  csv_range(LineRange&& r)
+      : LineRange{std::forward<LineRange>(r)},
+        headers_permutation_{read_header<T, Separator>(LineRange::begin())} {}
+
+  inline T read_row(cstr s) {
+    return decode_row<T>(s, headers_permutation_, splitter_);
+  }
+
   std::optional<T> begin() {
     cstr s;
     LineRange::next(s);
@@ -132,18 +417,77 @@ struct csv_range : public LineRange {
     return it.has_value();
   }
 
-  std::array<column_idx_t, MAX_COLUMNS> headers_permutation_;
+  csv_permutation headers_permutation_;
+  typename Mode::template row_splitter<Separator> splitter_;
 };
 
-template <typename T, char Separator = ','>
+// Like csv_range but yields csv_row<T> views instead of parsed rows.
+// The view is only valid until the range advances to the next row.
+template <typename T, typename LineRange, char Separator = ',',
+          typename Mode = scalar>
+struct csv_row_range : public LineRange {
+  using result_t = csv_row<T>;
+
+  csv_row_range(LineRange&& r)
+      : LineRange{std::forward<LineRange>(r)},
+        headers_permutation_{read_header<T, Separator>(LineRange::begin())} {}
+
+  csv_row<T> const* read_row() {
+    cstr s;
+    LineRange::next(s);
+    if (!LineRange::valid(s)) {
+      return nullptr;
+    }
+    row_.cells_.fill(cstr{});
+    splitter_.split(s, headers_permutation_, row_.cells_);
+    return &row_;
+  }
+
+  csv_row<T> const* begin() { return read_row(); }
+
+  template <typename It>
+  csv_row<T> const& read(It& it) const {
+    return *it;
+  }
+
+  template <typename It>
+  void next(It& it) {
+    it = read_row();
+  }
+
+  template <typename It>
+  bool valid(It& it) const {
+    return it != nullptr;
+  }
+
+  csv_permutation headers_permutation_;
+  typename Mode::template row_splitter<Separator> splitter_;
+  csv_row<T> row_;
+};
+
+template <typename T, char Separator = ',', typename Mode = scalar>
 struct csv {
   template <typename LineRange>
   friend auto operator|(LineRange&& r, csv&&) {
-    return csv_range<T, LineRange, Separator>{std::forward<LineRange>(r)};
+    return csv_range<T, LineRange, Separator, Mode>{
+        std::forward<LineRange>(r)};
+  }
+};
+
+template <typename T, char Separator = ',', typename Mode = scalar>
+struct csv_rows {
+  template <typename LineRange>
+  friend auto operator|(LineRange&& r, csv_rows&&) {
+    return csv_row_range<T, LineRange, Separator, Mode>{
+        std::forward<LineRange>(r)};
   }
 };
 
-template <typename T, typename LineRange, char Separator>
-struct is_range<csv_range<T, LineRange, Separator>> : std::true_type {};
+template <typename T, typename LineRange, char Separator, typename Mode>
+struct is_range<csv_range<T, LineRange, Separator, Mode>> : std::true_type {};
+
+template <typename T, typename LineRange, char Separator, typename Mode>
+struct is_range<csv_row_range<T, LineRange, Separator, Mode>>
+    : std::true_type {};
 
 }  // namespace utl
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "fmt/format.h"
+
+#include "utl/clear_t.h"
+#include "utl/parser/csv_range.h"
+
+#include "cista/reflection/for_each_field.h"
+
+namespace utl {
+
+constexpr auto const kDefaultCsvWriteBufferSize =
+    std::size_t{1024U * 1024U};
+
+// Formats rows of csv_col structs into a reusable buffer and hands it to
+// sink.write(char const*, std::size_t) in large blocks (utl::file,
+// mmap_writer, ...). Cells are only quoted if necessary.
+template <typename T, typename Sink, char Separator = ','>
+struct csv_writer {
+  explicit csv_writer(
+      Sink& sink, std::size_t const buffer_size = kDefaultCsvWriteBufferSize)
+      : sink_{sink}, buffer_size_{buffer_size} {}
+
+  csv_writer(csv_writer const&) = delete;
+  csv_writer& operator=(csv_writer const&) = delete;
+
+  // Call flush() explicitly to see write errors.
+  ~csv_writer() {
+    try {
+      flush();
+    } catch (...) {
+    }
+  }
+
+  void write_header() {
+    auto first = true;
+    cista::for_each_field<T>([&](auto&& f) {
+      if (!first) {
+        buf_.push_back(Separator);
+      }
+      first = false;
+      write_string(get_name(f));
+    });
+    end_row();
+  }
+
+  void write_row(T const& row) {
+    auto first = true;
+    cista::for_each_field(row, [&](auto const& f) {
+      if (!first) {
+        buf_.push_back(Separator);
+      }
+      first = false;
+      write_value(f.val());
+    });
+    end_row();
+  }
+
+  void end_row() {
+    buf_.push_back('\n');
+    if (buf_.size() >= buffer_size_) {
+      flush();
+    }
+  }
+
+  void flush() {
+    if (buf_.size() != 0U) {
+      sink_.write(buf_.data(), buf_.size());
+      buf_.clear();
+    }
+  }
+
+  template <typename V>
+  void write_value(V const& v) {
+    if constexpr (std::is_same_v<V, bool>) {
+      write_raw(v ? std::string_view{"true"} : std::string_view{"false"});
+    } else if constexpr (std::is_integral_v<V>) {
+      auto const f = fmt::format_int{v};
+      buf_.append(f.data(), f.data() + f.size());
+    } else if constexpr (std::is_floating_point_v<V>) {
+      fmt::format_to(std::back_inserter(buf_), "{}", v);
+    } else if constexpr (std::is_same_v<V, cstr>) {
+      write_string(v.view());
+    } else if constexpr (std::is_convertible_v<V const&, std::string_view>) {
+      write_string(std::string_view{v});
+    } else {
+      auto const s = fmt::format("{}", v);
+      write_string(s);
+    }
+  }
+
+  void write_raw(std::string_view const s) {
+    buf_.append(s.data(), s.data() + s.size());
+  }
+
+  // Quotes if the cell contains a separator, quote or line break.
+  // Quotes inside the cell are doubled. csv<T>() returns cells raw, use
+  // unescape_csv to undo this.
+  void write_string(std::string_view const s) {
+    if (s.find_first_of(kSpecial) == std::string_view::npos) {
+      write_raw(s);
+      return;
+    }
+
+    buf_.push_back('"');
+    for (auto const c : s) {
+      if (c == '"') {
+        buf_.push_back('"');
+      }
+      buf_.push_back(c);
+    }
+    buf_.push_back('"');
+  }
+
+  static constexpr char const kSpecial[] = {Separator, '"', '\n', '\r', '\0'};
+
+  Sink& sink_;
+  std::size_t buffer_size_;
+  fmt::memory_buffer buf_;
+};
+
+template <typename T, typename Sink, char Separator>
+struct write_csv_t {
+  // Writes the header and all rows, returns the number of rows.
+  template <typename Range>
+  friend std::size_t operator|(Range&& r, write_csv_t&& w) {
+    auto writer = csv_writer<T, Sink, Separator>{w.sink_, w.buffer_size_};
+    writer.write_header();
+
+    auto n_rows = std::size_t{0U};
+    auto it = r.begin();
+    while (r.valid(it)) {
+      writer.write_row(r.read(it));
+      ++n_rows;
+      r.next(it);
+    }
+    writer.flush();
+    return n_rows;
+  }
+
+  Sink& sink_;
+  std::size_t buffer_size_;
+};
+
+template <typename T, char Separator = ',', typename Sink>
+write_csv_t<T, Sink, Separator> write_csv(
+    Sink& sink, std::size_t const buffer_size = kDefaultCsvWriteBufferSize) {
+  return {sink, buffer_size};
+}
+
+}  // namespace utl
@@ -63,13 +63,14 @@ struct file {
     return filesize.QuadPart;
   }
 
-  buffer content() {
-    constexpr auto block_size = 8192u;
-    size_t const file_size = size();
+  buffer content() { return read_into(buffer(size())); }
 
-    auto b = buffer(file_size);
+  // Like content() but reuses memory of buffers returned to the pool.
+  buffer content(buffer_pool& pool) { return read_into(pool.get(size())); }
 
-    chunk(block_size, size(), [&](size_t const from, unsigned block_size) {
+  buffer read_into(buffer b) {
+    constexpr auto block_size = 8192u;
+    chunk(block_size, b.size(), [&](size_t const from, unsigned block_size) {
       OVERLAPPED overlapped = {0};
       overlapped.Offset = static_cast<DWORD>(from);
       overlapped.OffsetHigh = from >> 32u;
@@ -168,11 +169,14 @@ struct file {
     return s;
   }
 
-  buffer content() {
-    auto file_size = size();
-    auto b = buffer(file_size);
-    auto bytes_read = std::fread(b.data(), 1, file_size, f_);
-    verify(bytes_read == file_size, "file read error: {}", filename_);
+  buffer content() { return read_into(buffer(size())); }
+
+  // Like content() but reuses memory of buffers returned to the pool.
+  buffer content(buffer_pool& pool) { return read_into(pool.get(size())); }
+
+  buffer read_into(buffer b) {
+    auto bytes_read = std::fread(b.data(), 1, b.size(), f_);
+    verify(bytes_read == b.size(), "file read error: {}", filename_);
     return b;
   }
 
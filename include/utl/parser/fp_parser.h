@@ -0,0 +1,375 @@
+#pragma once
+
+#include <clocale>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <limits>
+#include <string>
+#include <type_traits>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#include <locale.h>
+#elif defined(__APPLE__)
+#include <xlocale.h>
+#else
+#include <locale.h>
+#endif
+
+#include "utl/parser/cstr.h"
+#include "utl/parser/powers_of_five.h"
+#include "utl/parser/swar.h"
+
+namespace utl {
+
+namespace detail {
+
+template <typename T>
+struct binary_format;
+
+template <>
+struct binary_format<double> {
+  using bits_t = std::uint64_t;
+  static constexpr auto const kMantissaBits = 52;
+  static constexpr auto const kMinExponent = -1023;
+  static constexpr auto const kInfinitePower = 0x7FF;
+  static constexpr auto const kSmallestPowerOfTen = -342;
+  static constexpr auto const kLargestPowerOfTen = 308;
+  static constexpr auto const kMinExponentRoundToEven = -4;
+  static constexpr auto const kMaxExponentRoundToEven = 23;
+  static constexpr auto const kMaxExponentFastPath = 22;
+};
+
+template <>
+struct binary_format<float> {
+  using bits_t = std::uint32_t;
+  static constexpr auto const kMantissaBits = 23;
+  static constexpr auto const kMinExponent = -127;
+  static constexpr auto const kInfinitePower = 0xFF;
+  static constexpr auto const kSmallestPowerOfTen = -65;
+  static constexpr auto const kLargestPowerOfTen = 38;
+  static constexpr auto const kMinExponentRoundToEven = -17;
+  static constexpr auto const kMaxExponentRoundToEven = 10;
+  static constexpr auto const kMaxExponentFastPath = 10;
+};
+
+inline constexpr double const kExactPowersOfTen[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+struct uint128 {
+  std::uint64_t low_, high_;
+};
+
+inline uint128 full_multiplication(std::uint64_t const a,
+                                   std::uint64_t const b) {
+#if defined(__SIZEOF_INT128__)
+  auto const r = static_cast<unsigned __int128>(a) * b;
+  return {static_cast<std::uint64_t>(r), static_cast<std::uint64_t>(r >> 64U)};
+#elif defined(_MSC_VER) && defined(_M_X64)
+  uint128 r;
+  r.low_ = _umul128(a, b, &r.high_);
+  return r;
+#else
+  auto const a_lo = a & 0xFFFFFFFFU, a_hi = a >> 32U;
+  auto const b_lo = b & 0xFFFFFFFFU, b_hi = b >> 32U;
+  auto const lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo;
+  auto const lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+  auto const cross = (lo_lo >> 32U) + (hi_lo & 0xFFFFFFFFU) + lo_hi;
+  return {(cross << 32U) | (lo_lo & 0xFFFFFFFFU),
+          (hi_lo >> 32U) + (cross >> 32U) + hi_hi};
+#endif
+}
+
+inline int leading_zeros(std::uint64_t const x) {
+#ifdef _MSC_VER
+  unsigned long idx;
+  _BitScanReverse64(&idx, x);
+  return 63 - static_cast<int>(idx);
+#else
+  return __builtin_clzll(x);
+#endif
+}
+
+struct adjusted_mantissa {
+  bool operator==(adjusted_mantissa const& o) const {
+    return mantissa_ == o.mantissa_ && power2_ == o.power2_;
+  }
+  bool operator!=(adjusted_mantissa const& o) const { return !(*this == o); }
+
+  std::uint64_t mantissa_{0U};
+  int power2_{0};
+};
+
+// Eisel-Lemire: computes the binary mantissa and exponent of w * 10^q
+// with correct rounding (round to nearest, ties to even).
+template <typename T>
+adjusted_mantissa compute_float(std::int64_t const q, std::uint64_t w) {
+  using fmt = binary_format<T>;
+
+  auto am = adjusted_mantissa{};
+  if (w == 0U || q < fmt::kSmallestPowerOfTen) {
+    return am;
+  }
+  if (q > fmt::kLargestPowerOfTen) {
+    am.power2_ = fmt::kInfinitePower;
+    return am;
+  }
+
+  auto const lz = leading_zeros(w);
+  w <<= static_cast<unsigned>(lz);
+
+  auto const index = 2U * static_cast<std::size_t>(q - kSmallestPowerOfFive);
+  auto product = full_multiplication(w, kPowersOfFive128[index]);
+  constexpr auto const precision_mask =
+      std::uint64_t{0xFFFFFFFFFFFFFFFFULL} >> (fmt::kMantissaBits + 3);
+  if ((product.high_ & precision_mask) == precision_mask) {
+    auto const second = full_multiplication(w, kPowersOfFive128[index + 1U]);
+    product.low_ += second.high_;
+    if (second.high_ > product.low_) {
+      ++product.high_;
+    }
+  }
+
+  auto const upper_bit = static_cast<int>(product.high_ >> 63U);
+  auto const shift =
+      static_cast<unsigned>(upper_bit + 64 - fmt::kMantissaBits - 3);
+  am.mantissa_ = product.high_ >> shift;
+
+  auto const power = static_cast<int>(
+      (((152170 + 65536) * static_cast<std::int32_t>(q)) >> 16) + 63);
+  am.power2_ = power + upper_bit - lz - fmt::kMinExponent;
+
+  if (am.power2_ <= 0) {  // subnormal
+    if (-am.power2_ + 1 >= 64) {
+      am.mantissa_ = 0U;
+      am.power2_ = 0;
+      return am;
+    }
+    am.mantissa_ >>= static_cast<unsigned>(-am.power2_ + 1);
+    am.mantissa_ += (am.mantissa_ & 1U);
+    am.mantissa_ >>= 1U;
+    am.power2_ =
+        (am.mantissa_ < (std::uint64_t{1U} << fmt::kMantissaBits)) ? 0 : 1;
+    return am;
+  }
+
+  // Exactly between two floats: round to even.
+  if (product.low_ <= 1U && q >= fmt::kMinExponentRoundToEven &&
+      q <= fmt::kMaxExponentRoundToEven && (am.mantissa_ & 3U) == 1U &&
+      (am.mantissa_ << shift) == product.high_) {
+    am.mantissa_ &= ~std::uint64_t{1U};
+  }
+
+  am.mantissa_ += (am.mantissa_ & 1U);
+  am.mantissa_ >>= 1U;
+  if (am.mantissa_ >= (std::uint64_t{2U} << fmt::kMantissaBits)) {
+    am.mantissa_ = std::uint64_t{1U} << fmt::kMantissaBits;
+    ++am.power2_;
+  }
+  am.mantissa_ &= ~(std::uint64_t{1U} << fmt::kMantissaBits);
+
+  if (am.power2_ >= fmt::kInfinitePower) {
+    am.power2_ = fmt::kInfinitePower;
+    am.mantissa_ = 0U;
+  }
+  return am;
+}
+
+template <typename T>
+T to_float(bool const negative, adjusted_mantissa const am) {
+  using fmt = binary_format<T>;
+  using bits_t = typename fmt::bits_t;
+  auto bits = static_cast<bits_t>(
+      am.mantissa_ |
+      (static_cast<std::uint64_t>(am.power2_) << fmt::kMantissaBits));
+  if (negative) {
+    bits |= bits_t{1U} << (sizeof(bits_t) * 8U - 1U);
+  }
+  T value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+inline bool is_digit(char const c) {
+  return static_cast<unsigned char>(c - '0') < 10U;
+}
+
+inline bool starts_with_ci(char const* p, char const* end, cstr word) {
+  if (static_cast<std::size_t>(end - p) < word.len) {
+    return false;
+  }
+  for (auto i = 0U; i != word.len; ++i) {
+    if ((p[i] | 0x20) != word[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// strtod/strtof honor LC_NUMERIC - the fallback always parses with "C".
+#ifdef _MSC_VER
+inline _locale_t c_numeric_locale() {
+  static auto const locale = _create_locale(LC_NUMERIC, "C");
+  return locale;
+}
+#else
+inline locale_t c_numeric_locale() {
+  static auto const locale = newlocale(LC_NUMERIC_MASK, "C", locale_t{});
+  return locale;
+}
+#endif
+
+template <typename T>
+T parse_fp_fallback(char const* begin, char const* end) {
+  auto const str = std::string{begin, end};
+  auto const locale = c_numeric_locale();
+#ifdef _MSC_VER
+  if constexpr (std::is_same_v<T, float>) {
+    return _strtof_l(str.c_str(), nullptr, locale);
+  } else {
+    return _strtod_l(str.c_str(), nullptr, locale);
+  }
+#else
+  if constexpr (std::is_same_v<T, float>) {
+    return strtof_l(str.c_str(), nullptr, locale);
+  } else {
+    return strtod_l(str.c_str(), nullptr, locale);
+  }
+#endif
+}
+
+}  // namespace detail
+
+// Parses [+-](digits)[.digits][(e|E)[+-]digits], "inf", "infinity" and
+// "nan" (case insensitive) with correct rounding.
+// s is advanced behind the number. Returns true if s was consumed entirely.
+template <typename T>
+inline bool parse_fp(cstr& s, T& v) {
+  using fmt = detail::binary_format<T>;
+  using detail::is_digit;
+
+  v = {};
+  if (!s) {
+    return false;
+  }
+
+  auto const begin = s.str;
+  auto const end = s.end();
+  auto p = begin;
+
+  auto const negative = (*p == '-');
+  if (negative || *p == '+') {
+    ++p;
+  }
+
+  if (p != end && !is_digit(*p) && *p != '.') {
+    if (detail::starts_with_ci(p, end, "nan")) {
+      v = std::numeric_limits<T>::quiet_NaN();
+      p += 3;
+    } else if (detail::starts_with_ci(p, end, "inf")) {
+      v = negative ? -std::numeric_limits<T>::infinity()
+                   : std::numeric_limits<T>::infinity();
+      p += detail::starts_with_ci(p, end, "infinity") ? 8 : 3;
+    } else {
+      s += static_cast<std::size_t>(p - begin);
+      return false;
+    }
+    s += static_cast<std::size_t>(p - begin);
+    return s.empty();
+  }
+
+  auto w = std::uint64_t{0U};
+  auto const int_begin = p;
+  p = parse_digits(p, end, w);
+  auto const int_end = p;
+  auto digit_count = static_cast<std::int64_t>(int_end - int_begin);
+
+  auto frac_begin = p;
+  auto exponent = std::int64_t{0};
+  if (p != end && *p == '.') {
+    ++p;
+    frac_begin = p;
+    p = parse_digits(p, end, w);
+    exponent = frac_begin - p;
+    digit_count -= exponent;
+  }
+  auto const frac_end = p;
+
+  if (digit_count == 0) {
+    s += static_cast<std::size_t>(p - begin);
+    return false;
+  }
+
+  auto exp_number = std::int64_t{0};
+  if (p != end && (*p == 'e' || *p == 'E')) {
+    auto q = p + 1;
+    auto const neg_exp = (q != end && *q == '-');
+    if (q != end && (*q == '-' || *q == '+')) {
+      ++q;
+    }
+    if (q != end && is_digit(*q)) {
+      while (q != end && is_digit(*q)) {
+        if (exp_number < 0x10000000) {
+          exp_number = 10 * exp_number + (*q - '0');
+        }
+        ++q;
+      }
+      exp_number = neg_exp ? -exp_number : exp_number;
+      exponent += exp_number;
+      p = q;
+    }
+  }
+  s += static_cast<std::size_t>(p - begin);
+
+  // More than 19 significant digits: w overflowed, use the first 19 only.
+  auto too_many_digits = false;
+  if (digit_count > 19) {
+    for (auto it = int_begin; it != frac_end && (*it == '0' || *it == '.');
+         ++it) {
+      digit_count -= (*it == '0') ? 1 : 0;
+    }
+    if (digit_count > 19) {
+      constexpr auto const kMinNineteenDigits = 1000000000000000000ULL;
+      too_many_digits = true;
+      w = 0U;
+      auto it = int_begin;
+      for (; w < kMinNineteenDigits && it != int_end; ++it) {
+        w = w * 10U + static_cast<std::uint64_t>(*it - '0');
+      }
+      if (w >= kMinNineteenDigits) {
+        exponent = (int_end - it) + exp_number;
+      } else {
+        for (it = frac_begin; w < kMinNineteenDigits && it != frac_end;
+             ++it) {
+          w = w * 10U + static_cast<std::uint64_t>(*it - '0');
+        }
+        exponent = (frac_begin - it) + exp_number;
+      }
+    }
+  }
+
+  // Clinger: mantissa and power of ten are exact, one rounding step.
+  if (!too_many_digits && exponent >= -fmt::kMaxExponentFastPath &&
+      exponent <= fmt::kMaxExponentFastPath &&
+      w <= (std::uint64_t{2U} << fmt::kMantissaBits)) {
+    v = static_cast<T>(w);
+    auto const power = static_cast<T>(
+        detail::kExactPowersOfTen[exponent < 0 ? -exponent : exponent]);
+    v = exponent < 0 ? v / power : v * power;
+    v = negative ? -v : v;
+  } else {
+    auto const am = detail::compute_float<T>(exponent, w);
+    if (too_many_digits && am != detail::compute_float<T>(exponent, w + 1U)) {
+      v = detail::parse_fp_fallback<T>(begin, p);
+    } else {
+      v = detail::to_float<T>(negative, am);
+    }
+  }
+
+  return s.empty();
+}
+
+}  // namespace utl
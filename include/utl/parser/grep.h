@@ -0,0 +1,91 @@
+#pragma once
+
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "utl/clear_t.h"
+#include "utl/parser/cstr.h"
+#include "utl/parser/multi_matcher.h"
+#include "utl/pipes/is_range.h"
+
+namespace utl {
+
+struct grep_match {
+  cstr line_;
+  std::vector<pattern_id> ids_;  // sorted, each matching pattern once
+};
+
+// Yields the lines of the parent range that contain at least one of the
+// patterns together with the ids of all patterns they contain.
+// The match is reused: read() returns a reference that is valid until
+// next() is called.
+template <typename Range>
+struct grep_range : public clear_t<Range> {
+  using parent_t = clear_t<Range>;
+  using result_t = grep_match;
+
+  template <typename T>
+  grep_range(T&& r, multi_matcher&& matcher)
+      : parent_t(std::forward<T>(r)), matcher_{std::move(matcher)} {}
+
+  template <typename It>
+  void find(It& it) {
+    while (parent_t::valid(it)) {
+      auto const line = cstr{parent_t::read(it)};
+      matcher_.find_all(line, match_.ids_);
+      if (!match_.ids_.empty()) {
+        match_.line_ = line;
+        return;
+      }
+      parent_t::next(it);
+    }
+  }
+
+  auto begin() {
+    auto it = parent_t::begin();
+    find(it);
+    return it;
+  }
+
+  template <typename It>
+  grep_match const& read(It&) const {
+    return match_;
+  }
+
+  template <typename It>
+  void next(It& it) {
+    parent_t::next(it);
+    find(it);
+  }
+
+  multi_matcher matcher_;
+  grep_match match_;
+};
+
+struct grep_t {
+  template <typename T>
+  friend auto operator|(T&& r, grep_t&& g) {
+    return grep_range<decltype(r)>(std::forward<T>(r), std::move(g.matcher_));
+  }
+
+  multi_matcher matcher_;
+};
+
+// Pattern ids are the indices in `patterns`.
+inline grep_t grep(multi_matcher matcher) { return {std::move(matcher)}; }
+
+template <typename Patterns>
+grep_t grep(Patterns const& patterns) {
+  return {multi_matcher{patterns}};
+}
+
+inline grep_t grep(std::initializer_list<cstr> patterns) {
+  return {multi_matcher{patterns}};
+}
+
+template <typename Range>
+struct is_range<grep_range<Range>> : std::true_type {};
+
+}  // namespace utl
@@ -0,0 +1,423 @@
+#pragma once
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "utl/parser/cstr.h"
+#include "utl/parser/file.h"
+#include "utl/parser/mmap_reader.h"
+#include "utl/parser/simd_scanner.h"
+#include "utl/thread_pool.h"
+#include "utl/verify.h"
+
+namespace utl {
+
+constexpr auto const kDefaultLineIndexChunkSize =
+    std::size_t{16U * 1024U * 1024U};
+
+// How load_or_build() checks that a persisted index belongs to the text:
+//   kFileStat: compares size, mtime and inode of the text file with the
+//              ones recorded in the index, without reading the text. Falls
+//              back to kFull if they differ (or without a text file path).
+//              Default if the path of the text file is known.
+//   kFull: hashes the whole text (one parallel read pass). Default for a
+//          text given only as memory.
+//   kSampled: hashes a bounded sample (prefix, suffix and evenly spaced
+//             blocks), cost independent of the text size. Misses an edit
+//             that keeps the size and touches no sampled block - only for
+//             texts that are replaced as a whole, never edited in place.
+enum class line_index_check { kFileStat, kFull, kSampled };
+
+namespace detail {
+
+// Calls fn(offset) for every newline in s (offset relative to s).
+template <typename Fn>
+void for_each_newline(cstr const s, Fn&& fn) {
+  auto const scan = get_block_scan_fn<1U>();
+  block_masks<1U> masks;
+  for (auto offset = std::size_t{0U}; offset < s.len; offset += kBlockSize) {
+    scan_block<1U>(scan, s.str + offset, s.len - offset, {'\n'}, masks);
+    for (auto m = masks[0]; m != 0U; m &= m - 1U) {
+      fn(offset + trailing_zeros(m));
+    }
+  }
+}
+
+inline std::uint64_t mix_hash(std::uint64_t h, std::uint64_t const w) {
+  h = (h ^ w) * 0x9E3779B97F4A7C15ULL;
+  return h ^ (h >> 29U);
+}
+
+inline std::uint64_t hash_bytes(cstr const s) {
+  auto h = std::uint64_t{s.len};
+  auto i = std::size_t{0U};
+  for (; i + 8U <= s.len; i += 8U) {
+    auto w = std::uint64_t{};
+    std::memcpy(&w, s.str + i, 8U);
+    h = mix_hash(h, w);
+  }
+  auto w = std::uint64_t{0U};
+  if (i != s.len) {
+    std::memcpy(&w, s.str + i, s.len - i);
+  }
+  return mix_hash(h, w);
+}
+
+// Size, modification time and inode of a file (inode is 0 on Windows).
+// All zero if the file cannot be accessed.
+struct file_identity {
+  bool valid() const { return mtime_ns_ != 0U; }
+
+  std::uint64_t size_{0U};
+  std::uint64_t mtime_ns_{0U};
+  std::uint64_t inode_{0U};
+};
+
+inline file_identity get_file_identity(char const* path) {
+#ifdef _WIN32
+  struct _stat64 st {};
+  if (_stat64(path, &st) != 0) {
+    return {};
+  }
+  return {static_cast<std::uint64_t>(st.st_size),
+          static_cast<std::uint64_t>(st.st_mtime) * 1000000000U, 0U};
+#else
+  struct stat st {};
+  if (stat(path, &st) != 0) {
+    return {};
+  }
+#ifdef __APPLE__
+  auto const& mtime = st.st_mtimespec;
+#else
+  auto const& mtime = st.st_mtim;
+#endif
+  return {static_cast<std::uint64_t>(st.st_size),
+          static_cast<std::uint64_t>(mtime.tv_sec) * 1000000000U +
+              static_cast<std::uint64_t>(mtime.tv_nsec),
+          static_cast<std::uint64_t>(st.st_ino)};
+#endif
+}
+
+inline std::size_t count_newlines(cstr const s) {
+  auto const scan = get_block_scan_fn<1U>();
+  auto n = std::size_t{0U};
+  block_masks<1U> masks;
+  for (auto offset = std::size_t{0U}; offset < s.len; offset += kBlockSize) {
+    scan_block<1U>(scan, s.str + offset, s.len - offset, {'\n'}, masks);
+    n += pop_count(masks[0]);
+  }
+  return n;
+}
+
+}  // namespace detail
+
+// Start offsets of all lines of a text for O(1) access to line n.
+// Lines are the same as the ones returned by read_line(): without '\n',
+// no empty line after a final newline.
+//
+// The index can be written to a file and loaded with mmap. The file holds
+// a header (magic, size and content hash of the indexed text, line count,
+// mtime and inode of the text file if known) followed by line count + 1
+// offsets (the last one is the end of the text).
+struct line_index {
+  static constexpr char const kMagic[8] = {'U', 'T', 'L', 'L',
+                                           'I', 'D', 'X', '3'};
+
+  struct header {
+    char magic_[8];
+    std::uint64_t data_size_;
+    std::uint64_t n_lines_;
+    std::uint64_t data_hash_;
+    std::uint64_t file_mtime_ns_;
+    std::uint64_t file_inode_;
+  };
+
+  line_index() = default;
+
+  line_index(line_index&& o) noexcept { *this = std::move(o); }
+
+  line_index& operator=(line_index&& o) noexcept {
+    owned_ = std::move(o.owned_);
+    map_ = std::move(o.map_);
+    offsets_ = owned_.empty() ? o.offsets_ : owned_.data();
+    n_lines_ = o.n_lines_;
+    o.offsets_ = nullptr;
+    o.n_lines_ = 0U;
+    return *this;
+  }
+
+  line_index(line_index const&) = delete;
+  line_index& operator=(line_index const&) = delete;
+
+  // Counts newlines of all chunks in parallel, then writes the offsets of
+  // each chunk in parallel starting at the prefix sum of the counts.
+  static line_index build(
+      thread_pool& pool, cstr const data,
+      std::size_t const chunk_size = kDefaultLineIndexChunkSize) {
+    auto const n_chunks =
+        std::max(std::size_t{1U}, (data.len + chunk_size - 1U) / chunk_size);
+    auto const chunk = [&](std::size_t const i) {
+      return data.substr(i * chunk_size, utl::size(chunk_size));
+    };
+
+    std::vector<std::size_t> first_line(n_chunks + 1U);
+    pool.execute(n_chunks, [&](std::size_t const i) {
+      first_line[i + 1U] = detail::count_newlines(chunk(i));
+    });
+    for (auto i = 0U; i != n_chunks; ++i) {
+      first_line[i + 1U] += first_line[i];
+    }
+
+    auto const n_newlines = first_line[n_chunks];
+    auto const ends_with_newline = data.len != 0U && data[data.len - 1] == '\n';
+    auto const n_lines =
+        data.len == 0U ? 0U : n_newlines + (ends_with_newline ? 0U : 1U);
+
+    line_index idx;
+    idx.owned_.resize(n_newlines + 2U);
+    idx.owned_[0] = 0U;
+    pool.execute(n_chunks, [&](std::size_t const i) {
+      auto out = first_line[i] + 1U;
+      detail::for_each_newline(chunk(i), [&](std::size_t const offset) {
+        idx.owned_[out++] = i * chunk_size + offset + 1U;
+      });
+    });
+    idx.owned_.resize(n_lines + 1U);
+    if (n_lines != 0U && !ends_with_newline) {
+      idx.owned_[n_lines] = data.len + 1U;  // as if followed by a newline
+    }
+    idx.offsets_ = idx.owned_.data();
+    idx.n_lines_ = n_lines;
+    return idx;
+  }
+
+  // Hash of the text stored with the index. Chunks are hashed in parallel;
+  // the chunk size is fixed so the hash does not depend on the pool.
+  static std::uint64_t content_hash(thread_pool& pool, cstr const data) {
+    constexpr auto const kChunkSize = kDefaultLineIndexChunkSize;
+    auto const n_chunks =
+        std::max(std::size_t{1U}, (data.len + kChunkSize - 1U) / kChunkSize);
+    std::vector<std::uint64_t> chunk_hashes(n_chunks);
+    pool.execute(n_chunks, [&](std::size_t const i) {
+      chunk_hashes[i] = detail::hash_bytes(
+          data.substr(i * kChunkSize, utl::size(kChunkSize)));
+    });
+    auto h = std::uint64_t{data.len};
+    for (auto const chunk_hash : chunk_hashes) {
+      h = detail::mix_hash(h, chunk_hash);
+    }
+    return h;
+  }
+
+  // Hash of at most 2 * kEdge + kSamples * kSampleSize bytes of the text:
+  // prefix, suffix and blocks spread evenly over the rest. Texts up to that
+  // size are hashed completely (same value as content_hash).
+  static std::uint64_t sampled_hash(cstr const data) {
+    constexpr auto const kEdge = std::size_t{1024U * 1024U};
+    constexpr auto const kSamples = std::size_t{64U};
+    constexpr auto const kSampleSize = std::size_t{4096U};
+    if (data.len <= 2U * kEdge + kSamples * kSampleSize) {
+      return detail::mix_hash(data.len, detail::hash_bytes(data));
+    }
+    auto h = std::uint64_t{data.len};
+    h = detail::mix_hash(
+        h, detail::hash_bytes(data.substr(0U, utl::size(kEdge))));
+    h = detail::mix_hash(
+        h, detail::hash_bytes(data.substr(data.len - kEdge, utl::size(kEdge))));
+    auto const middle = data.len - 2U * kEdge;
+    for (auto i = std::size_t{0U}; i != kSamples; ++i) {
+      auto const offset = kEdge + (middle - kSampleSize) * i / (kSamples - 1U);
+      h = detail::mix_hash(
+          h, detail::hash_bytes(data.substr(offset, utl::size(kSampleSize))));
+    }
+    return h;
+  }
+
+  // Loads an index written with write(). Returns std::nullopt if the file
+  // does not exist, was built for a different text (size or content hash)
+  // or is malformed (offsets not increasing or out of bounds).
+  static std::optional<line_index> load(char const* path,
+                                        std::size_t const data_size,
+                                        std::uint64_t const data_hash) {
+    return load_if(path, data_size, [&](header const& h) {
+      return h.data_hash_ == data_hash;
+    });
+  }
+
+  // Same, but accepts the index if it records the given size, mtime and
+  // inode of the text file instead of checking the content hash.
+  static std::optional<line_index> load(char const* path,
+                                        detail::file_identity const& id) {
+    if (!id.valid()) {
+      return std::nullopt;
+    }
+    return load_if(path, id.size_, [&](header const& h) {
+      return h.file_mtime_ns_ == id.mtime_ns_ && h.file_inode_ == id.inode_;
+    });
+  }
+
+  template <typename Accept>
+  static std::optional<line_index> load_if(char const* path,
+                                           std::size_t const data_size,
+                                           Accept&& accept) {
+    auto idx = line_index{};
+    try {
+      idx.map_.emplace(path);
+    } catch (std::exception const&) {
+      return std::nullopt;
+    }
+
+    auto const& m = *idx.map_;
+    if (m.size() < sizeof(header)) {
+      return std::nullopt;
+    }
+
+    header h;
+    std::memcpy(&h, m.ptr(), sizeof(h));
+    auto const payload = m.size() - sizeof(header);
+    if (std::memcmp(h.magic_, kMagic, sizeof(kMagic)) != 0 ||
+        h.data_size_ != data_size || !accept(h) ||
+        payload % sizeof(std::uint64_t) != 0U ||
+        payload / sizeof(std::uint64_t) == 0U ||
+        h.n_lines_ != payload / sizeof(std::uint64_t) - 1U) {
+      return std::nullopt;
+    }
+
+    // Every line contains at least its newline, the last offset may be one
+    // past the end (no final newline).
+    auto const offsets = reinterpret_cast<std::uint64_t const*>(
+        m.ptr() + sizeof(header));
+    auto const n_lines = static_cast<std::size_t>(h.n_lines_);
+    if (offsets[0] != 0U || offsets[n_lines] > data_size + 1U) {
+      return std::nullopt;
+    }
+    for (auto i = std::size_t{0U}; i != n_lines; ++i) {
+      if (offsets[i] >= offsets[i + 1U]) {
+        return std::nullopt;
+      }
+    }
+
+    idx.offsets_ = offsets;
+    idx.n_lines_ = n_lines;
+    return idx;
+  }
+
+  // Loads the index at index_path if it fits data, otherwise builds it
+  // and writes it to index_path. An index written with the other hash check
+  // is rebuilt unless the text is small enough to be hashed completely.
+  static line_index load_or_build(
+      thread_pool& pool, cstr const data, char const* index_path,
+      line_index_check const check = line_index_check::kFull) {
+    auto const hash = check == line_index_check::kSampled
+                          ? sampled_hash(data)
+                          : content_hash(pool, data);
+    if (auto idx = load(index_path, data.len, hash); idx.has_value()) {
+      return std::move(*idx);
+    }
+    auto idx = build(pool, data);
+    idx.write(index_path, data.len, hash);
+    return idx;
+  }
+
+  // Same for data = content of the file at data_path (e.g. its memory map).
+  // With kFileStat, an index that records the current size, mtime and inode
+  // of data_path is loaded without reading data, so loading stays cheap
+  // compared to build(). Otherwise (file replaced, copied or touched) the
+  // content hash decides; a matching index is written again with the new
+  // record. Edits that keep size and mtime (restored afterwards, or within
+  // the mtime resolution of the file system) need kFull.
+  static line_index load_or_build(
+      thread_pool& pool, cstr const data, char const* data_path,
+      char const* index_path,
+      line_index_check const check = line_index_check::kFileStat) {
+    auto const id = detail::get_file_identity(data_path);
+    auto const use_stat =
+        check == line_index_check::kFileStat && id.size_ == data.len;
+    if (use_stat) {
+      if (auto idx = load(index_path, id); idx.has_value()) {
+        return std::move(*idx);
+      }
+    }
+
+    auto const hash = check == line_index_check::kSampled
+                          ? sampled_hash(data)
+                          : content_hash(pool, data);
+    if (auto idx = load(index_path, data.len, hash); idx.has_value()) {
+      if (use_stat && id.valid()) {
+        idx->owned_.assign(idx->offsets_, idx->offsets_ + idx->n_lines_ + 1U);
+        idx->offsets_ = idx->owned_.data();
+        idx->map_.reset();
+        idx->write(index_path, data.len, hash, id);
+      }
+      return std::move(*idx);
+    }
+    auto idx = build(pool, data);
+    idx.write(index_path, data.len, hash, id);
+    return idx;
+  }
+
+  void write(char const* path, std::size_t const data_size,
+             std::uint64_t const data_hash,
+             detail::file_identity const& id = {}) const {
+    auto h = header{};
+    std::memcpy(h.magic_, kMagic, sizeof(kMagic));
+    h.data_size_ = data_size;
+    h.n_lines_ = n_lines_;
+    h.data_hash_ = data_hash;
+    h.file_mtime_ns_ = id.mtime_ns_;
+    h.file_inode_ = id.inode_;
+
+    auto f = file{path, "w+"};
+    f.write(&h, sizeof(h));
+    f.write(offsets_, (n_lines_ + 1U) * sizeof(std::uint64_t));
+  }
+
+  std::size_t size() const { return n_lines_; }
+
+  std::size_t offset(std::size_t const n) const {
+    return static_cast<std::size_t>(offsets_[n]);
+  }
+
+  cstr line(cstr const data, std::size_t const n) const {
+    return data.substr(offset(n), offset(n + 1U) - 1U);
+  }
+
+  // Text of lines [from, to) including their newlines (from <= to).
+  cstr lines(cstr const data, std::size_t const from,
+             std::size_t const to) const {
+    return data.substr(offset(from), offset(to));
+  }
+
+  // Splits [0, size()) into n_parts contiguous line ranges of about the
+  // same number of lines.
+  std::vector<std::pair<std::size_t, std::size_t>> split(
+      std::size_t const n_parts) const {
+    auto parts = std::vector<std::pair<std::size_t, std::size_t>>{};
+    auto const n = std::max(std::size_t{1U}, n_parts);
+    for (auto i = std::size_t{0U}; i != n; ++i) {
+      auto const from = n_lines_ * i / n;
+      auto const to = n_lines_ * (i + 1U) / n;
+      if (from != to) {
+        parts.emplace_back(from, to);
+      }
+    }
+    return parts;
+  }
+
+  std::vector<std::uint64_t> owned_;
+  std::optional<mmap_reader::memory_map> map_;
+  std::uint64_t const* offsets_{nullptr};
+  std::size_t n_lines_{0U};
+};
+
+}  // namespace utl
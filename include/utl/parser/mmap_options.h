@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+
+namespace utl {
+
+// Tuning of the file mapping of mmap_reader (ignored where unsupported).
+struct mmap_options {
+  bool sequential_{false};  // MADV_SEQUENTIAL: aggressive read ahead
+  bool will_need_{false};  // MADV_WILLNEED: start reading the whole file
+  bool populate_{false};  // MAP_POPULATE: prefault all pages on mmap()
+  bool huge_pages_{false};  // MADV_HUGEPAGE: transparent huge page hint
+
+  // If != 0: every release_behind_ bytes, pages behind the read cursor are
+  // dropped from the mapping and the page cache, so large scans do not
+  // evict the rest of the page cache.
+  std::size_t release_behind_{0U};
+};
+
+}  // namespace utl
@@ -1,5 +1,8 @@
 #pragma once
 
+// mmap_reader is available on POSIX and Windows. Its counterpart
+// mmap_writer (mmap_writer.h) is POSIX only.
+
 #ifdef _WIN32
 #include "utl/parser/mmap_reader_msvc.h"
 #else
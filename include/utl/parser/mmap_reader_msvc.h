@@ -7,6 +7,7 @@
 #include <algorithm>
 
 #include "utl/parser/cstr.h"
+#include "utl/parser/mmap_options.h"
 
 namespace utl {
 
@@ -58,7 +59,7 @@ struct mmap_reader {
   };
 
   struct memory_map {
-    explicit memory_map(char const* path)
+    explicit memory_map(char const* path, mmap_options const& = {})
         : f_{path}, fmap_{static_cast<char*>(mmap(f_.f_, f_.size_))} {
       if (fmap_ == nullptr) {  // NOLINT
         throw std::runtime_error("cannot memory map file");
@@ -109,7 +110,9 @@ struct mmap_reader {
     char* fmap_;
   };
 
-  explicit mmap_reader(char const* filename) : m_(filename), it_(m_.ptr()) {}
+  // mmap_options are not supported on Windows and ignored.
+  explicit mmap_reader(char const* filename, mmap_options const& opt = {})
+      : m_(filename, opt), it_(m_.ptr()) {}
 
   cstr read(size_t const num_bytes) {
     auto const start = it_;
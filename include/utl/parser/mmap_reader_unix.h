@@ -8,10 +8,12 @@
 #include <cstdlib>
 #include <cstring>
 
+#include <algorithm>
 #include <stdexcept>
 #include <utility>
 
 #include "utl/parser/cstr.h"
+#include "utl/parser/mmap_options.h"
 
 namespace utl {
 
@@ -61,13 +63,57 @@ struct mmap_reader {
   };
 
   struct memory_map {
-    explicit memory_map(char const* path)
+    explicit memory_map(char const* path, mmap_options const& opt = {})
         : f_{path},
-          fmap_{static_cast<char*>(
-              mmap(nullptr, f_.size_, PROT_READ, MAP_PRIVATE, f_.fd_, 0))} {
+          fmap_{static_cast<char*>(mmap(nullptr, f_.size_, PROT_READ,
+                                        MAP_PRIVATE | populate_flag(opt),
+                                        f_.fd_, 0))} {
       if (fmap_ == MAP_FAILED) {  // NOLINT
         throw std::runtime_error("cannot memory map file");
       }
+      advise(opt);
+    }
+
+    static int populate_flag(mmap_options const& opt) {
+#ifdef MAP_POPULATE
+      return opt.populate_ ? MAP_POPULATE : 0;
+#else
+      (void)opt;
+      return 0;
+#endif
+    }
+
+    // Hints only: failures are ignored.
+    void advise(mmap_options const& opt) {
+      if (opt.sequential_) {
+        madvise(fmap_, f_.size_, MADV_SEQUENTIAL);
+      }
+      if (opt.will_need_) {
+        madvise(fmap_, f_.size_, MADV_WILLNEED);
+      }
+#ifdef MADV_HUGEPAGE
+      if (opt.huge_pages_) {
+        madvise(fmap_, f_.size_, MADV_HUGEPAGE);
+      }
+#endif
+    }
+
+    // Drops the pages in [from, to) of the file from the mapping and the
+    // page cache. Offsets are rounded inwards to page boundaries.
+    // Returns the end of the released range (from if nothing was released).
+    size_t release(size_t const from, size_t const to) {
+      static auto const page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+      auto const first = (from + page_size - 1U) / page_size * page_size;
+      auto const last = to / page_size * page_size;
+      if (first >= last) {
+        return from;
+      }
+      madvise(fmap_ + first, last - first, MADV_DONTNEED);
+#ifdef POSIX_FADV_DONTNEED
+      posix_fadvise(f_.fd_, static_cast<off_t>(first),
+                    static_cast<off_t>(last - first), POSIX_FADV_DONTNEED);
+#endif
+      return last;
     }
 
     memory_map(memory_map&& o) noexcept
@@ -98,7 +144,10 @@ struct mmap_reader {
     char* fmap_;
   };
 
-  explicit mmap_reader(char const* filename) : m_(filename), it_(m_.ptr()) {}
+  explicit mmap_reader(char const* filename, mmap_options const& opt = {})
+      : m_(filename, opt),
+        it_(m_.ptr()),
+        release_behind_{opt.release_behind_} {}
 
   mmap_reader(mmap_reader&&) = default;
   mmap_reader& operator=(mmap_reader&&) = default;
@@ -112,6 +161,7 @@ struct mmap_reader {
     auto const rest_size = static_cast<size_t>(last - start);
     auto const bytes_read = std::min(num_bytes, rest_size);
     it_ += bytes_read;
+    release_behind();
     return {start, bytes_read};
   }
 
@@ -131,15 +181,31 @@ struct mmap_reader {
     auto const length = nl != nullptr ? nl - start : last - it_;
     it_ = nl;
     ++it_;
+    release_behind();
     return {start, static_cast<size_t>(length)};
   }
 
+  // Releases everything more than release_behind_ bytes before the cursor.
+  // Released pages are read again from the file if accessed, so lines that
+  // are still in use stay valid.
+  void release_behind() {
+    if (release_behind_ == 0U) {
+      return;
+    }
+    auto const pos = static_cast<size_t>(it_ - m_.ptr());
+    if (pos - released_ >= 2U * release_behind_) {
+      released_ = m_.release(released_, pos - release_behind_);
+    }
+  }
+
   float progress() const {
     return (it_ - m_.ptr()) / static_cast<float>(m_.size());
   }
 
   memory_map m_;
   char* it_;
+  size_t release_behind_{0U};
+  size_t released_{0U};
 };
 
 }  // namespace utl
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include <algorithm>
+#include <utility>
+
+#include "utl/parser/cstr.h"
+#include "utl/verify.h"
+
+namespace utl {
+
+constexpr auto const kDefaultMmapWriterGrowth =
+    std::size_t{64U * 1024U * 1024U};
+
+enum class mmap_sync {
+  kNone,  // write back is left to the kernel
+  kAsyncOnGrow,  // msync(MS_ASYNC) of the written part on every growth step
+  kSyncOnClose  // msync(MS_SYNC) + fsync on close
+};
+
+// Append only file writer on a shared writable mapping. The file is grown
+// in steps of `growth` bytes and truncated to the written size on close.
+// Growth allocates the blocks with posix_fallocate (ftruncate on macOS), so
+// a full disk is reported by reserve() / write() instead of a SIGBUS on the
+// first store into a sparse page. POSIX only.
+struct mmap_writer {
+  explicit mmap_writer(char const* path,
+                       mmap_sync const sync = mmap_sync::kNone,
+                       std::size_t const growth = kDefaultMmapWriterGrowth)
+      : fd_{open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)},
+        sync_{sync},
+        growth_{std::max(growth, page_size())} {
+    utl::verify(fd_ != -1, "unable to open file {}: {}", path,
+                std::strerror(errno));
+  }
+
+  mmap_writer(mmap_writer&& o) noexcept
+      : fd_{std::exchange(o.fd_, -1)},
+        sync_{o.sync_},
+        growth_{o.growth_},
+        map_{std::exchange(o.map_, nullptr)},
+        size_{std::exchange(o.size_, 0U)},
+        capacity_{std::exchange(o.capacity_, 0U)} {}
+
+  mmap_writer& operator=(mmap_writer&& o) noexcept {
+    if (this != &o) {
+      try {
+        close();
+      } catch (...) {
+      }
+      fd_ = std::exchange(o.fd_, -1);
+      sync_ = o.sync_;
+      growth_ = o.growth_;
+      map_ = std::exchange(o.map_, nullptr);
+      size_ = std::exchange(o.size_, 0U);
+      capacity_ = std::exchange(o.capacity_, 0U);
+    }
+    return *this;
+  }
+
+  mmap_writer(mmap_writer const&) = delete;
+  mmap_writer& operator=(mmap_writer const&) = delete;
+
+  ~mmap_writer() {
+    try {
+      close();
+    } catch (...) {
+    }
+  }
+
+  // Returns space for n bytes at the end of the file. The bytes become part
+  // of the file with commit(). Invalidated by the next reserve() / write().
+  char* reserve(std::size_t const n) {
+    if (size_ + n > capacity_) {
+      grow(size_ + n);
+    }
+    return map_ + size_;
+  }
+
+  void commit(std::size_t const n) { size_ += n; }
+
+  void write(char const* data, std::size_t const n) {
+    if (n != 0U) {
+      std::memcpy(reserve(n), data, n);
+      commit(n);
+    }
+  }
+
+  void write(cstr const s) { write(s.str, s.len); }
+
+  void write(char const c) {
+    *reserve(1U) = c;
+    commit(1U);
+  }
+
+  std::size_t size() const { return size_; }
+
+  // Unmaps, truncates the file to the written size and closes it.
+  void close() {
+    if (fd_ == -1) {
+      return;
+    }
+
+    auto const fd = std::exchange(fd_, -1);
+    if (map_ != nullptr) {
+      if (sync_ == mmap_sync::kSyncOnClose && size_ != 0U) {
+        msync(map_, size_, MS_SYNC);
+      }
+      munmap(map_, capacity_);
+      map_ = nullptr;
+    }
+
+    auto error = 0;
+    if (ftruncate(fd, static_cast<off_t>(size_)) != 0) {
+      error = errno;
+    } else if (sync_ == mmap_sync::kSyncOnClose && fsync(fd) != 0) {
+      error = errno;
+    }
+    ::close(fd);
+    utl::verify(error == 0, "mmap_writer close error: {}",
+                std::strerror(error));
+  }
+
+  void grow(std::size_t const min_capacity) {
+    if (sync_ == mmap_sync::kAsyncOnGrow && size_ != 0U) {
+      msync(map_, size_, MS_ASYNC);
+    }
+
+    auto const new_capacity =
+        (min_capacity + growth_ - 1U) / growth_ * growth_;
+#ifdef __APPLE__
+    utl::verify(ftruncate(fd_, static_cast<off_t>(new_capacity)) == 0,
+                "mmap_writer ftruncate error: {}", std::strerror(errno));
+#else
+    auto const error =
+        posix_fallocate(fd_, static_cast<off_t>(capacity_),
+                        static_cast<off_t>(new_capacity - capacity_));
+    utl::verify(error == 0, "mmap_writer fallocate error: {}",
+                std::strerror(error));
+#endif
+
+    void* new_map = MAP_FAILED;
+#ifdef __linux__
+    if (map_ != nullptr) {
+      new_map = mremap(map_, capacity_, new_capacity, MREMAP_MAYMOVE);
+    }
+#endif
+    if (new_map == MAP_FAILED) {
+      if (map_ != nullptr) {
+        munmap(map_, capacity_);
+        map_ = nullptr;
+      }
+      new_map = mmap(nullptr, new_capacity, PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd_, 0);
+      utl::verify(new_map != MAP_FAILED, "mmap_writer mmap error: {}",
+                  std::strerror(errno));
+    }
+
+    map_ = static_cast<char*>(new_map);
+    capacity_ = new_capacity;
+  }
+
+  static std::size_t page_size() {
+    return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  }
+
+  int fd_;
+  mmap_sync sync_;
+  std::size_t growth_;
+  char* map_{nullptr};
+  std::size_t size_{0U}, capacity_{0U};
+};
+
+}  // namespace utl
@@ -0,0 +1,338 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "utl/parser/cstr.h"
+#include "utl/parser/simd_scanner.h"
+#include "utl/verify.h"
+
+namespace utl {
+
+using pattern_id = std::uint32_t;
+
+namespace detail {
+
+constexpr auto const kTeddyBuckets = 8U;
+constexpr auto const kTeddyMaxFingerprint = 3U;
+constexpr auto const kTeddyBlockSize = 32U;
+
+// Nibble tables of the Teddy prefilter: bit b of lo_[k][x] (hi_[k][x]) is
+// set if a pattern of bucket b has low (high) nibble x at position k.
+struct teddy_masks {
+  std::array<std::array<std::uint8_t, 16U>, kTeddyMaxFingerprint> lo_{}, hi_{};
+  unsigned fingerprint_{0U};
+};
+
+#ifdef UTL_SIMD_AVX2
+// Byte j of out is the set of buckets whose fingerprint matches p + j.
+// Returns the mask of non-zero bytes. Reads 32 + fingerprint - 1 bytes.
+__attribute__((target("avx2"))) inline std::uint32_t teddy_block_avx2(
+    char const* p, teddy_masks const& m, std::uint8_t* out) {
+  auto const nibble = _mm256_set1_epi8(0x0F);
+  auto res = _mm256_set1_epi8(-1);
+  for (auto k = 0U; k != m.fingerprint_; ++k) {
+    auto const lo = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(m.lo_[k].data())));
+    auto const hi = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(m.hi_[k].data())));
+    auto const v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p + k));
+    res = _mm256_and_si256(
+        res,
+        _mm256_and_si256(
+            _mm256_shuffle_epi8(lo, _mm256_and_si256(v, nibble)),
+            _mm256_shuffle_epi8(
+                hi, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble))));
+  }
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), res);
+  return ~static_cast<std::uint32_t>(_mm256_movemask_epi8(
+      _mm256_cmpeq_epi8(res, _mm256_setzero_si256())));
+}
+#endif
+
+inline bool teddy_supported() {
+#ifdef UTL_SIMD_AVX2
+  static auto const supported = __builtin_cpu_supports("avx2") != 0;
+  return supported;
+#else
+  return false;
+#endif
+}
+
+template <typename Fn>
+bool call_match_fn(Fn& fn, pattern_id const id, std::size_t const pos) {
+  if constexpr (std::is_same_v<decltype(fn(id, pos)), continue_t>) {
+    return fn(id, pos) == continue_t::kContinue;
+  } else {
+    fn(id, pos);
+    return true;
+  }
+}
+
+}  // namespace detail
+
+// Finds all occurrences of a set of patterns in one pass.
+//
+// Small pattern sets (up to kTeddyMaxPatterns) are searched with a
+// Teddy-style prefilter if AVX2 is available: the first up to three bytes
+// of each pattern are matched 32 positions at a time via nibble lookup
+// tables and only candidate positions are verified. All other sets use an
+// Aho-Corasick automaton with resolved transitions over byte classes.
+struct multi_matcher {
+  static constexpr auto const kTeddyMaxPatterns = 32U;
+  static constexpr auto const kNoState =
+      std::numeric_limits<std::uint32_t>::max();
+
+  multi_matcher() = default;
+
+  template <typename Patterns>
+  explicit multi_matcher(Patterns const& patterns) {
+    for (auto const& p : patterns) {
+      auto const s = cstr{p};
+      utl::verify(s.len != 0U, "multi_matcher: empty pattern");
+      patterns_.emplace_back(s.view());
+    }
+    build_automaton();
+    if (patterns_.size() <= kTeddyMaxPatterns && detail::teddy_supported()) {
+      build_teddy();
+    }
+  }
+
+  multi_matcher(std::initializer_list<cstr> patterns)
+      : multi_matcher{std::vector<cstr>{patterns}} {}
+
+  std::size_t size() const { return patterns_.size(); }
+  std::string const& pattern(pattern_id const id) const {
+    return patterns_[id];
+  }
+  bool uses_teddy() const { return teddy_.fingerprint_ != 0U; }
+
+  // Calls fn(pattern_id, start offset) for every occurrence (overlapping
+  // ones included) in unspecified order. Stops if fn returns kBreak.
+  template <typename Fn>
+  void for_each_match(cstr const s, Fn&& fn) const {
+    if (s.len == 0U || patterns_.empty()) {
+      return;
+    }
+    if (uses_teddy()) {
+      for_each_match_teddy(s, fn);
+    } else {
+      for_each_match_automaton(s, fn);
+    }
+  }
+
+  bool matches(cstr const s) const {
+    auto found = false;
+    for_each_match(s, [&](pattern_id, std::size_t) {
+      found = true;
+      return continue_t::kBreak;
+    });
+    return found;
+  }
+
+  // Sorted ids of all patterns occurring in s (each id once).
+  void find_all(cstr const s, std::vector<pattern_id>& ids) const {
+    ids.clear();
+    for_each_match(s, [&](pattern_id const id, std::size_t) {
+      ids.push_back(id);
+    });
+    std::sort(begin(ids), end(ids));
+    ids.erase(std::unique(begin(ids), end(ids)), end(ids));
+  }
+
+  template <typename Fn>
+  void for_each_match_automaton(cstr const s, Fn& fn) const {
+    auto state = std::uint32_t{0U};
+    for (auto i = std::size_t{0U}; i != s.len; ++i) {
+      state = delta_[state * n_classes_ +
+                     class_[static_cast<unsigned char>(s.str[i])]];
+      for (auto o = out_begin_[state]; o != out_begin_[state + 1U]; ++o) {
+        auto const id = out_[o];
+        if (!detail::call_match_fn(fn, id, i + 1U - patterns_[id].size())) {
+          return;
+        }
+      }
+    }
+  }
+
+#ifdef UTL_SIMD_AVX2
+  template <typename Fn>
+  void for_each_match_teddy(cstr const s, Fn& fn) const {
+    std::uint8_t buckets[detail::kTeddyBlockSize];
+    auto const verify_block = [&](std::size_t const pos,
+                                  std::uint32_t mask) {
+      for (; mask != 0U; mask &= mask - 1U) {
+        auto const j = trailing_zeros(mask);
+        for (auto b = unsigned{buckets[j]}; b != 0U; b &= b - 1U) {
+          for (auto const id : bucket_patterns_[trailing_zeros(b)]) {
+            auto const& p = patterns_[id];
+            auto const start = pos + j;
+            if (start + p.size() <= s.len &&
+                std::memcmp(s.str + start, p.data(), p.size()) == 0 &&
+                !detail::call_match_fn(fn, id, start)) {
+              return false;
+            }
+          }
+        }
+      }
+      return true;
+    };
+
+    auto const overlap = teddy_.fingerprint_ - 1U;
+    auto i = std::size_t{0U};
+    for (; i + detail::kTeddyBlockSize + overlap <= s.len;
+         i += detail::kTeddyBlockSize) {
+      auto const mask = detail::teddy_block_avx2(s.str + i, teddy_, buckets);
+      if (mask != 0U && !verify_block(i, mask)) {
+        return;
+      }
+    }
+
+    // Tail: copy to a zero padded buffer, positions past the end are
+    // rejected by the bounds check in verify_block.
+    char tail[2U * detail::kTeddyBlockSize + detail::kTeddyMaxFingerprint] = {};
+    auto const rest = s.len - i;
+    std::memcpy(tail, s.str + i, rest);
+    for (auto t = std::size_t{0U}; t < rest; t += detail::kTeddyBlockSize) {
+      auto const mask = detail::teddy_block_avx2(tail + t, teddy_, buckets);
+      if (mask != 0U && !verify_block(i + t, mask)) {
+        return;
+      }
+    }
+  }
+#else
+  template <typename Fn>
+  void for_each_match_teddy(cstr const s, Fn& fn) const {
+    for_each_match_automaton(s, fn);
+  }
+#endif
+
+  void build_automaton() {
+    class_.fill(0U);
+    n_classes_ = 1U;  // class 0: bytes not occurring in any pattern
+    for (auto const& p : patterns_) {
+      for (auto const c : p) {
+        auto& cls = class_[static_cast<unsigned char>(c)];
+        if (cls == 0U) {
+          cls = static_cast<std::uint16_t>(n_classes_++);
+        }
+      }
+    }
+
+    // Trie.
+    delta_.assign(n_classes_, kNoState);
+    auto own_out = std::vector<std::vector<pattern_id>>(1U);
+    for (auto id = pattern_id{0U}; id != patterns_.size(); ++id) {
+      auto state = std::uint32_t{0U};
+      for (auto const c : patterns_[id]) {
+        auto const cls = class_[static_cast<unsigned char>(c)];
+        if (delta_[state * n_classes_ + cls] == kNoState) {
+          auto const next = static_cast<std::uint32_t>(own_out.size());
+          delta_[state * n_classes_ + cls] = next;
+          delta_.resize(delta_.size() + n_classes_, kNoState);
+          own_out.emplace_back();
+        }
+        state = delta_[state * n_classes_ + cls];
+      }
+      own_out[state].push_back(id);
+    }
+
+    // Breadth first: failure links, resolved transitions and outputs
+    // (own outputs followed by those of the failure state).
+    auto const n_states = own_out.size();
+    auto fail = std::vector<std::uint32_t>(n_states, 0U);
+    auto out = std::vector<std::vector<pattern_id>>(n_states);
+    auto queue = std::vector<std::uint32_t>{};
+    out[0] = own_out[0];
+    for (auto cls = 0U; cls != n_classes_; ++cls) {
+      auto& next = delta_[cls];
+      if (next == kNoState) {
+        next = 0U;
+      } else {
+        queue.push_back(next);
+      }
+    }
+    for (auto q = std::size_t{0U}; q != queue.size(); ++q) {
+      auto const state = queue[q];
+      out[state] = own_out[state];
+      out[state].insert(end(out[state]), begin(out[fail[state]]),
+                        end(out[fail[state]]));
+      for (auto cls = 0U; cls != n_classes_; ++cls) {
+        auto& next = delta_[state * n_classes_ + cls];
+        auto const fallback = delta_[fail[state] * n_classes_ + cls];
+        if (next == kNoState) {
+          next = fallback;
+        } else {
+          fail[next] = fallback;
+          queue.push_back(next);
+        }
+      }
+    }
+
+    out_begin_.resize(n_states + 1U);
+    out_.clear();
+    for (auto state = std::size_t{0U}; state != n_states; ++state) {
+      out_begin_[state] = static_cast<std::uint32_t>(out_.size());
+      out_.insert(end(out_), begin(out[state]), end(out[state]));
+    }
+    out_begin_[n_states] = static_cast<std::uint32_t>(out_.size());
+  }
+
+  void build_teddy() {
+    auto min_len = std::numeric_limits<std::size_t>::max();
+    for (auto const& p : patterns_) {
+      min_len = std::min(min_len, p.size());
+    }
+    teddy_ = detail::teddy_masks{};
+    teddy_.fingerprint_ = static_cast<unsigned>(
+        std::min(min_len, std::size_t{detail::kTeddyMaxFingerprint}));
+
+    // Patterns sharing a fingerprint go to the same bucket.
+    auto order = std::vector<pattern_id>(patterns_.size());
+    for (auto id = pattern_id{0U}; id != order.size(); ++id) {
+      order[id] = id;
+    }
+    auto const fingerprint = [&](pattern_id const id) {
+      return patterns_[id].substr(0U, teddy_.fingerprint_);
+    };
+    std::stable_sort(begin(order), end(order), [&](auto const a, auto const b) {
+      return fingerprint(a) < fingerprint(b);
+    });
+
+    for (auto i = 0U; i != order.size(); ++i) {
+      auto const bucket =
+          static_cast<unsigned>(i * detail::kTeddyBuckets / order.size());
+      auto const& p = patterns_[order[i]];
+      bucket_patterns_[bucket].push_back(order[i]);
+      for (auto k = 0U; k != teddy_.fingerprint_; ++k) {
+        auto const c = static_cast<unsigned char>(p[k]);
+        teddy_.lo_[k][c & 0x0FU] |= static_cast<std::uint8_t>(1U << bucket);
+        teddy_.hi_[k][c >> 4U] |= static_cast<std::uint8_t>(1U << bucket);
+      }
+    }
+  }
+
+  std::vector<std::string> patterns_;
+
+  // Aho-Corasick automaton: delta_[state * n_classes_ + class_[byte]],
+  // out_[out_begin_[state], out_begin_[state + 1]) are the patterns ending
+  // in state.
+  std::array<std::uint16_t, 256U> class_{};
+  std::size_t n_classes_{1U};
+  std::vector<std::uint32_t> delta_;
+  std::vector<std::uint32_t> out_begin_;
+  std::vector<pattern_id> out_;
+
+  detail::teddy_masks teddy_;
+  std::array<std::vector<pattern_id>, detail::kTeddyBuckets> bucket_patterns_;
+};
+
+}  // namespace utl
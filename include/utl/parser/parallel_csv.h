@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cstdint>
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+#include "utl/parser/csv_range.h"
+#include "utl/parser/mmap_reader.h"
+#include "utl/parser/simd_scanner.h"
+#include "utl/parser/structural_index.h"
+#include "utl/thread_pool.h"
+
+namespace utl {
+
+constexpr auto const kDefaultCsvChunkSize = std::size_t{16U * 1024U * 1024U};
+
+namespace detail {
+
+// Chunk statistics for both possible quote states at the chunk start.
+// row_start_[s] is the offset of the first row starting in the chunk
+// given the chunk starts in quote state s (0 = outside, 1 = inside quotes).
+struct csv_chunk_info {
+  static constexpr auto const kNone = std::numeric_limits<std::size_t>::max();
+
+  bool quote_parity_{false};
+  std::array<std::size_t, 2U> row_start_{kNone, kNone};
+};
+
+inline csv_chunk_info analyze_csv_chunk(cstr chunk) {
+  auto const scan = get_block_scan_fn<2U>();
+  auto info = csv_chunk_info{};
+  auto in_quote_carry = std::uint64_t{0U};
+  block_masks<2U> masks;
+  for (auto offset = std::size_t{0U}; offset < chunk.len;
+       offset += kBlockSize) {
+    scan_block<2U>(scan, chunk.str + offset, chunk.len - offset, {'\n', '"'},
+                   masks);
+
+    auto const in_quote = prefix_xor(masks[1]) ^ in_quote_carry;
+    in_quote_carry =
+        static_cast<std::uint64_t>(static_cast<std::int64_t>(in_quote) >> 63);
+    info.quote_parity_ ^= (pop_count(masks[1]) & 1U) != 0U;
+
+    auto const outside = masks[0] & ~in_quote;
+    auto const inside = masks[0] & in_quote;
+    if (outside != 0U && info.row_start_[0] == csv_chunk_info::kNone) {
+      info.row_start_[0] = offset + trailing_zeros(outside) + 1U;
+    }
+    if (inside != 0U && info.row_start_[1] == csv_chunk_info::kNone) {
+      info.row_start_[1] = offset + trailing_zeros(inside) + 1U;
+    }
+  }
+  return info;
+}
+
+// Calls fn for every row in s. Newlines inside quotes do not end a row.
+template <typename Fn>
+void for_each_csv_row(cstr s, Fn&& fn) {
+  auto scanner = block_scanner<2U>{s.str, s.len, {'\n', '"'}};
+  auto in_quote = false;
+  auto row_begin = s.begin();
+  for (auto pos = scanner.next(); pos != s.end(); pos = scanner.next()) {
+    if (*pos == '"') {
+      in_quote = !in_quote;
+    } else if (!in_quote) {
+      fn(cstr{row_begin, pos});
+      row_begin = pos + 1;
+    }
+  }
+  if (row_begin != s.end()) {
+    fn(cstr{row_begin, s.end()});
+  }
+}
+
+// Splits the body into chunks with row aligned boundaries.
+// Each chunk is analyzed speculatively for both quote start states in
+// parallel. The actual quote state at each chunk start is resolved
+// afterwards from the quote parities of all previous chunks.
+// A chunk size of 0 is treated as 1.
+inline std::vector<cstr> split_csv_chunks(
+    thread_pool& pool, cstr body, std::size_t const requested_chunk_size) {
+  auto const chunk_size = std::max(std::size_t{1U}, requested_chunk_size);
+  auto const n_chunks =
+      std::max(std::size_t{1U}, (body.len + chunk_size - 1U) / chunk_size);
+
+  std::vector<csv_chunk_info> info(n_chunks);
+  pool.execute(n_chunks, [&](std::size_t const i) {
+    info[i] = analyze_csv_chunk(body.substr(i * chunk_size, size(chunk_size)));
+  });
+
+  std::vector<bool> in_quote(n_chunks);
+  for (auto i = 1U; i < n_chunks; ++i) {
+    in_quote[i] = in_quote[i - 1U] != info[i - 1U].quote_parity_;
+  }
+
+  std::vector<std::size_t> boundaries(n_chunks + 1U);
+  boundaries[n_chunks] = body.len;
+  for (auto i = n_chunks - 1U; i != 0U; --i) {
+    auto const row_start = info[i].row_start_[in_quote[i] ? 1U : 0U];
+    boundaries[i] = (row_start == csv_chunk_info::kNone)
+                        ? boundaries[i + 1U]
+                        : i * chunk_size + row_start;
+  }
+
+  std::vector<cstr> chunks(n_chunks);
+  for (auto i = 0U; i != n_chunks; ++i) {
+    chunks[i] = body.substr(boundaries[i], boundaries[i + 1U]);
+  }
+  return chunks;
+}
+
+template <typename T, char Separator, typename Mode>
+std::vector<T> parse_csv_chunk(
+    cstr chunk, csv_permutation const& headers_permutation) {
+  auto splitter = typename Mode::template row_splitter<Separator>{};
+  auto rows = std::vector<T>{};
+  for_each_csv_row(chunk, [&](cstr const row) {
+    if (!strip_cr(row).empty()) {
+      rows.emplace_back(decode_row<T>(row, headers_permutation, splitter));
+    }
+  });
+  return rows;
+}
+
+}  // namespace detail
+
+// Header and row aligned chunks of a CSV file.
+template <typename T, char Separator = ','>
+struct csv_chunks {
+  csv_chunks(thread_pool& pool, cstr data, std::size_t const chunk_size) {
+    auto const header = get_until(data, '\n');
+    headers_permutation_ = read_header<T, Separator>(strip_cr(header));
+    chunks_ = detail::split_csv_chunks(
+        pool, data.substr(std::min(header.len + 1U, data.len)), chunk_size);
+  }
+
+  csv_permutation headers_permutation_;
+  std::vector<cstr> chunks_;
+};
+
+// Parses the CSV in data on the thread pool and returns all rows in order.
+// The default mode is simd because only the structural index keeps quoted
+// newlines inside a cell.
+template <typename T, char Separator = ',', typename Mode = simd>
+std::vector<T> parallel_csv(
+    thread_pool& pool, cstr data,
+    std::size_t const chunk_size = kDefaultCsvChunkSize) {
+  auto const c = csv_chunks<T, Separator>{pool, data, chunk_size};
+
+  std::vector<std::vector<T>> batches(c.chunks_.size());
+  pool.execute(c.chunks_.size(), [&](std::size_t const i) {
+    batches[i] = detail::parse_csv_chunk<T, Separator, Mode>(
+        c.chunks_[i], c.headers_permutation_);
+  });
+
+  auto n_rows = std::size_t{0U};
+  for (auto const& b : batches) {
+    n_rows += b.size();
+  }
+
+  std::vector<T> rows;
+  rows.reserve(n_rows);
+  for (auto& b : batches) {
+    std::move(begin(b), end(b), std::back_inserter(rows));
+  }
+  return rows;
+}
+
+template <typename T, char Separator = ',', typename Mode = simd>
+std::vector<T> parallel_csv(
+    thread_pool& pool, mmap_reader::memory_map const& m,
+    std::size_t const chunk_size = kDefaultCsvChunkSize) {
+  return parallel_csv<T, Separator, Mode>(pool, cstr{m.ptr(), m.size()},
+                                          chunk_size);
+}
+
+// Parses the CSV in data on the thread pool and hands the rows of each
+// chunk to fn(std::vector<T>&&) as soon as the chunk is done.
+// fn is called concurrently from the worker threads in no particular order.
+template <typename T, char Separator = ',', typename Mode = simd,
+          typename Fn>
+void parallel_csv_batches(
+    thread_pool& pool, cstr data, Fn&& fn,
+    std::size_t const chunk_size = kDefaultCsvChunkSize) {
+  auto const c = csv_chunks<T, Separator>{pool, data, chunk_size};
+  pool.execute(c.chunks_.size(), [&](std::size_t const i) {
+    fn(detail::parse_csv_chunk<T, Separator, Mode>(c.chunks_[i],
+                                                   c.headers_permutation_));
+  });
+}
+
+}  // namespace utl
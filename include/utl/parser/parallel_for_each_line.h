@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstring>
+
+#include <algorithm>
+#include <atomic>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "utl/parser/cstr.h"
+#include "utl/parser/mmap_reader.h"
+#include "utl/thread_pool.h"
+
+namespace utl {
+
+constexpr auto const kDefaultLineChunkSize = std::size_t{1024U * 1024U};
+
+namespace detail {
+
+// Chunks of about chunk_size bytes. Every chunk except the last one ends
+// directly after a newline.
+inline std::vector<cstr> split_line_chunks(cstr const data,
+                                           std::size_t const chunk_size) {
+  auto chunks = std::vector<cstr>{};
+  auto from = std::size_t{0U};
+  while (from < data.len) {
+    auto to = std::min(from + std::max(chunk_size, std::size_t{1U}), data.len);
+    if (to != data.len) {
+      auto const nl = static_cast<char const*>(
+          std::memchr(data.str + to - 1U, '\n', data.len - to + 1U));
+      to = nl == nullptr ? data.len
+                         : static_cast<std::size_t>(nl - data.str) + 1U;
+    }
+    chunks.emplace_back(data.substr(from, to));
+    from = to;
+  }
+  return chunks;
+}
+
+}  // namespace detail
+
+// Calls fn(state, line) for all lines of data (same lines as
+// for_each_line) on the thread pool.
+//
+// The data is split into chunks on line boundaries. Each worker creates
+// its own state with init() and processes chunks until none are left.
+// Finally, the states are combined with merge(State& into, State&& from)
+// in worker order and the result is returned. Lines of one chunk are
+// processed in order, chunks in no particular order.
+template <typename InitFn, typename Fn, typename MergeFn>
+auto parallel_for_each_line(
+    thread_pool& pool, cstr const data, InitFn&& init, Fn&& fn,
+    MergeFn&& merge, std::size_t const chunk_size = kDefaultLineChunkSize) {
+  using state_t = std::decay_t<decltype(init())>;
+
+  auto const chunks = detail::split_line_chunks(data, chunk_size);
+  auto const n_workers =
+      std::max(std::size_t{1U}, std::min(chunks.size(), pool.size()));
+
+  auto states = std::vector<std::optional<state_t>>(n_workers);
+  auto next_chunk = std::atomic_size_t{0U};
+  pool.execute(n_workers, [&](std::size_t const worker) {
+    auto& state = states[worker].emplace(init());
+    for (auto i = next_chunk.fetch_add(1U); i < chunks.size();
+         i = next_chunk.fetch_add(1U)) {
+      for_each_line(chunks[i], [&](cstr const line) { fn(state, line); });
+    }
+  });
+
+  auto result = std::move(*states[0]);
+  for (auto i = 1U; i < n_workers; ++i) {
+    merge(result, std::move(*states[i]));
+  }
+  return result;
+}
+
+// Same as parallel_for_each_line, but for the lines of the file at path,
+// which is memory mapped for the duration of the call. An empty file
+// (which cannot be mapped) has no lines: the result is init().
+template <typename InitFn, typename Fn, typename MergeFn>
+auto parallel_for_each_line_in_file(
+    thread_pool& pool, std::string const& path, InitFn&& init, Fn&& fn,
+    MergeFn&& merge, std::size_t const chunk_size = kDefaultLineChunkSize) {
+  using state_t = std::decay_t<decltype(init())>;
+  if (mmap_reader::file{path.c_str()}.size_ == 0U) {
+    return state_t(init());
+  }
+
+  auto const m = mmap_reader::memory_map{path.c_str()};
+  return parallel_for_each_line(pool, cstr{m.ptr(), m.size()},
+                                std::forward<InitFn>(init),
+                                std::forward<Fn>(fn),
+                                std::forward<MergeFn>(merge), chunk_size);
+}
+
+}  // namespace utl
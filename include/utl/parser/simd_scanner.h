@@ -0,0 +1,202 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include <array>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <emmintrin.h>
+#include <immintrin.h>
+#define UTL_SIMD_SSE2 1
+#if defined(__GNUC__) || defined(__clang__)
+#define UTL_SIMD_AVX2 1
+#endif
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace utl {
+
+constexpr auto const kBlockSize = std::size_t{64U};
+
+template <std::size_t N>
+using block_masks = std::array<std::uint64_t, N>;
+
+template <std::size_t N>
+using block_scan_fn_t = void (*)(char const*, std::array<char, N> const&,
+                                 block_masks<N>&);
+
+inline unsigned trailing_zeros(std::uint64_t const x) {
+#ifdef _MSC_VER
+  unsigned long idx;
+  _BitScanForward64(&idx, x);
+  return static_cast<unsigned>(idx);
+#else
+  return static_cast<unsigned>(__builtin_ctzll(x));
+#endif
+}
+
+// Index of the most significant set bit (x != 0).
+inline unsigned highest_bit(std::uint64_t const x) {
+#ifdef _MSC_VER
+  unsigned long idx;
+  _BitScanReverse64(&idx, x);
+  return static_cast<unsigned>(idx);
+#else
+  return 63U - static_cast<unsigned>(__builtin_clzll(x));
+#endif
+}
+
+inline unsigned pop_count(std::uint64_t const x) {
+#ifdef _MSC_VER
+  return static_cast<unsigned>(__popcnt64(x));
+#else
+  return static_cast<unsigned>(__builtin_popcountll(x));
+#endif
+}
+
+namespace detail {
+
+template <std::size_t N>
+void scan_block_scalar(char const* p, std::array<char, N> const& needles,
+                       block_masks<N>& masks) {
+  masks.fill(0U);
+  for (auto i = 0U; i != kBlockSize; ++i) {
+    for (auto n = 0U; n != N; ++n) {
+      masks[n] |= static_cast<std::uint64_t>(p[i] == needles[n]) << i;
+    }
+  }
+}
+
+#ifdef UTL_SIMD_SSE2
+template <std::size_t N>
+void scan_block_sse2(char const* p, std::array<char, N> const& needles,
+                     block_masks<N>& masks) {
+  __m128i in[4];
+  for (auto i = 0U; i != 4U; ++i) {
+    in[i] = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p + i * 16U));
+  }
+  for (auto n = 0U; n != N; ++n) {
+    auto const needle = _mm_set1_epi8(needles[n]);
+    auto mask = std::uint64_t{0U};
+    for (auto i = 0U; i != 4U; ++i) {
+      auto const eq = _mm_movemask_epi8(_mm_cmpeq_epi8(in[i], needle));
+      mask |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(eq))
+              << (i * 16U);
+    }
+    masks[n] = mask;
+  }
+}
+#endif
+
+#ifdef UTL_SIMD_AVX2
+template <std::size_t N>
+__attribute__((target("avx2"))) void scan_block_avx2(
+    char const* p, std::array<char, N> const& needles, block_masks<N>& masks) {
+  auto const lo = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+  auto const hi = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p + 32));
+  for (auto n = 0U; n != N; ++n) {
+    auto const needle = _mm256_set1_epi8(needles[n]);
+    auto const lo_eq = _mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle));
+    auto const hi_eq = _mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle));
+    masks[n] = static_cast<std::uint64_t>(static_cast<std::uint32_t>(lo_eq)) |
+               (static_cast<std::uint64_t>(static_cast<std::uint32_t>(hi_eq))
+                << 32U);
+  }
+}
+#endif
+
+template <std::size_t N>
+block_scan_fn_t<N> select_block_scan_fn() {
+#ifdef UTL_SIMD_AVX2
+  if (__builtin_cpu_supports("avx2")) {
+    return &scan_block_avx2<N>;
+  }
+#endif
+#ifdef UTL_SIMD_SSE2
+  return &scan_block_sse2<N>;
+#else
+  return &scan_block_scalar<N>;
+#endif
+}
+
+}  // namespace detail
+
+template <std::size_t N>
+block_scan_fn_t<N> get_block_scan_fn() {
+  static auto const fn = detail::select_block_scan_fn<N>();
+  return fn;
+}
+
+// Computes one bit mask per needle for the block starting at p.
+// Bit i of masks[n] is set iff p[i] == needles[n].
+// Reads at most `available` bytes (a partial block is zero-padded and masked).
+template <std::size_t N>
+void scan_block(block_scan_fn_t<N> const scan, char const* p,
+                std::size_t const available,
+                std::array<char, N> const& needles, block_masks<N>& masks) {
+  if (available >= kBlockSize) {
+    scan(p, needles, masks);
+  } else {
+    alignas(kBlockSize) char tail[kBlockSize] = {};
+    std::memcpy(tail, p, available);
+    scan(tail, needles, masks);
+    auto const valid = (std::uint64_t{1U} << available) - 1U;
+    for (auto& m : masks) {
+      m &= valid;
+    }
+  }
+}
+
+// Yields the positions of all needle occurrences in ascending order.
+// Returns the end of the input once all occurrences have been consumed.
+template <std::size_t N>
+struct block_scanner {
+  block_scanner() = default;
+  block_scanner(char const* str, std::size_t const len,
+                std::array<char, N> needles)
+      : str_{str}, len_{len}, needles_{needles}, scan_{get_block_scan_fn<N>()} {
+    load();
+  }
+
+  char const* end() const { return str_ + len_; }
+
+  char const* next() {
+    while (mask_ == 0U) {
+      offset_ += kBlockSize;
+      if (offset_ >= len_) {
+        offset_ = len_;
+        return end();
+      }
+      load();
+    }
+    auto const pos = str_ + offset_ + trailing_zeros(mask_);
+    mask_ &= mask_ - 1U;
+    return pos;
+  }
+
+  void load() {
+    if (offset_ >= len_) {
+      mask_ = 0U;
+      return;
+    }
+    block_masks<N> masks;
+    scan_block<N>(scan_, str_ + offset_, len_ - offset_, needles_, masks);
+    mask_ = 0U;
+    for (auto const m : masks) {
+      mask_ |= m;
+    }
+  }
+
+  char const* str_{nullptr};
+  std::size_t len_{0U};
+  std::array<char, N> needles_{};
+  block_scan_fn_t<N> scan_{nullptr};
+  std::size_t offset_{0U};
+  std::uint64_t mask_{0U};
+};
+
+}  // namespace utl
@@ -1,26 +1,96 @@
 #pragma once
 
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
 #include "utl/parser/csv.h"
+#include "utl/parser/simd_scanner.h"
 
 namespace utl {
 
-template <char Separator = ',', typename... Ts>
-std::tuple<Ts...> split(cstr s) {
+// Quoted cells (kept as is, including "" escapes) and '\r' line endings.
+struct split_quoted {
+  template <char Separator, typename Tuple>
+  static void split(cstr s, Tuple& ret) {
+    std::apply(
+        [&](auto&... args) {
+          auto const parse_col = [&](auto& arg) {
+            auto col = cstr{};
+            parse_column<cstr, Separator>(s, col);
+            parse_arg(col, arg);
+            if (s) {
+              ++s;
+            }
+          };
+          (parse_col(args), ...);
+        },
+        ret);
+  }
+};
+
+// Unquoted cells: a cell ends at the next separator. The separators are
+// found with one vectorized pass over the input. Missing cells are empty,
+// additional cells are ignored.
+struct split_no_quote {
+  template <char Separator, typename Tuple>
+  static void split(cstr const s, Tuple& ret) {
+    auto scanner = block_scanner<1U>{s.str, s.len, {Separator}};
+    auto it = s.str;
+    std::apply(
+        [&](auto&... args) {
+          auto const parse_col = [&](auto& arg) {
+            auto const end = scanner.next();
+            auto col = cstr{it, end};
+            parse_arg(col, arg);
+            it = end + (end != s.end() ? 1 : 0);
+          };
+          (parse_col(args), ...);
+        },
+        ret);
+  }
+};
+
+// Unquoted cells, exactly one per tuple element: only the first N - 1
+// separators are searched, the last cell is the rest of the input.
+struct split_fixed {
+  template <char Separator, typename Tuple>
+  static void split(cstr const s, Tuple& ret) {
+    split<Separator>(s, ret,
+                     std::make_index_sequence<std::tuple_size_v<Tuple>>());
+  }
+
+  template <char Separator, typename Tuple, std::size_t... I>
+  static void split(cstr const s, Tuple& ret, std::index_sequence<I...>) {
+    auto scanner = block_scanner<1U>{s.str, s.len, {Separator}};
+    auto it = s.str;
+    auto const parse_col = [&](auto& arg, auto const is_last) {
+      char const* end;
+      if constexpr (decltype(is_last)::value) {
+        end = s.end();
+      } else {
+        end = scanner.next();
+      }
+      auto col = cstr{it, end};
+      parse_arg(col, arg);
+      it = end + (end != s.end() ? 1 : 0);
+    };
+    (parse_col(std::get<I>(ret),
+               std::bool_constant<I + 1U == sizeof...(I)>{}),
+     ...);
+  }
+};
+
+template <typename Policy, char Separator, typename... Ts>
+std::tuple<Ts...> split_with(cstr const s) {
   std::tuple<Ts...> ret;
-  auto const parse_col =
-      [&]<std::size_t I>(std::integral_constant<std::size_t, I>) {
-        auto col = cstr{};
-        parse_column<cstr, Separator>(s, col);
-        parse_arg(col, std::get<I>(ret));
-        if (s) {
-          ++s;
-        }
-      };
-  auto const parse_tuple = [&]<std::size_t... I>(std::index_sequence<I...>) {
-    (parse_col(std::integral_constant<std::size_t, I>{}), ...);
-  };
-  parse_tuple(std::make_index_sequence<sizeof...(Ts)>());
+  Policy::template split<Separator>(s, ret);
   return ret;
 }
 
-}  // namespace utl
\ No newline at end of file
+template <char Separator = ',', typename... Ts>
+std::tuple<Ts...> split(cstr const s) {
+  return split_with<split_quoted, Separator, Ts...>(s);
+}
+
+}  // namespace utl
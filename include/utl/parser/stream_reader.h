@@ -0,0 +1,176 @@
+#pragma once
+
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
+
+#include <algorithm>
+#include <utility>
+
+#include "utl/parser/buffer.h"
+#include "utl/parser/cstr.h"
+#include "utl/verify.h"
+
+namespace utl {
+
+constexpr auto const kDefaultStreamBlockSize = std::size_t{1024U * 1024U};
+
+// Line reader for non seekable inputs (pipes, stdin, sockets).
+// Reads fixed size blocks into one buffer. Only the unfinished line at the
+// end of a block is moved to the front before the next read, so memory use
+// is bounded by the block size (or the longest line if that is larger).
+// The returned line is valid until the next call to read_line().
+struct stream_reader {
+  // Closes the descriptor on destruction if owned. A member (declared
+  // before buf_) so a throwing constructor does not leak an opened file.
+  struct file_descriptor {
+    file_descriptor(int const fd, bool const owned) : fd_{fd}, owned_{owned} {}
+
+    file_descriptor(file_descriptor&& o) noexcept
+        : fd_{std::exchange(o.fd_, -1)},
+          owned_{std::exchange(o.owned_, false)} {}
+
+    file_descriptor& operator=(file_descriptor&& o) noexcept {
+      close_file();
+      fd_ = std::exchange(o.fd_, -1);
+      owned_ = std::exchange(o.owned_, false);
+      return *this;
+    }
+
+    file_descriptor(file_descriptor const&) = delete;
+    file_descriptor& operator=(file_descriptor const&) = delete;
+
+    ~file_descriptor() { close_file(); }
+
+    void close_file() {
+      if (owned_ && fd_ != -1) {
+#ifdef _WIN32
+        _close(fd_);
+#else
+        close(fd_);
+#endif
+      }
+      fd_ = -1;
+      owned_ = false;
+    }
+
+    int fd_;
+    bool owned_;
+  };
+
+  explicit stream_reader(int const fd,
+                         std::size_t const block_size = kDefaultStreamBlockSize)
+      : fd_{fd, false}, buf_(std::max(block_size, std::size_t{1U})) {}
+
+  explicit stream_reader(char const* path,
+                         std::size_t const block_size = kDefaultStreamBlockSize)
+      : fd_{open_file(path), true},
+        buf_(std::max(block_size, std::size_t{1U})) {}
+
+  stream_reader(stream_reader&& o) noexcept
+      : fd_{std::move(o.fd_)},
+        buf_{std::move(o.buf_)},
+        begin_{o.begin_},
+        end_{o.end_},
+        eof_{o.eof_} {}
+
+  stream_reader& operator=(stream_reader&& o) noexcept {
+    fd_ = std::move(o.fd_);
+    buf_ = std::move(o.buf_);
+    begin_ = o.begin_;
+    end_ = o.end_;
+    eof_ = o.eof_;
+    return *this;
+  }
+
+  stream_reader(stream_reader const&) = delete;
+  stream_reader& operator=(stream_reader const&) = delete;
+
+  ~stream_reader() = default;
+
+  cstr read_line() {
+    auto search_from = begin_;
+    while (true) {
+      auto const nl = static_cast<char const*>(
+          std::memchr(data() + search_from, '\n', end_ - search_from));
+      if (nl != nullptr) {
+        auto const line = cstr{data() + begin_, nl};
+        begin_ = static_cast<std::size_t>(nl - data()) + 1U;
+        return line;
+      }
+
+      if (eof_) {
+        if (begin_ == end_) {
+          return {nullptr, 0};
+        }
+        auto const line = cstr{data() + begin_, end_ - begin_};
+        begin_ = end_;
+        return line;
+      }
+
+      search_from = end_ - begin_;
+      fill();
+    }
+  }
+
+  // Moves the unfinished line to the front and appends the next block.
+  void fill() {
+    if (begin_ != 0U) {
+      std::memmove(data(), data() + begin_, end_ - begin_);
+      end_ -= begin_;
+      begin_ = 0U;
+    }
+    if (end_ == buf_.size()) {
+      buf_.resize(2U * buf_.size());
+    }
+
+    auto const n = read_block(data() + end_, buf_.size() - end_);
+    if (n == 0U) {
+      eof_ = true;
+    }
+    end_ += n;
+  }
+
+  std::size_t read_block(char* dest, std::size_t const size) {
+    while (true) {
+#ifdef _WIN32
+      auto const n = _read(fd_.fd_, dest, static_cast<unsigned>(
+                                           std::min(size, std::size_t{1U}
+                                                              << 30U)));
+#else
+      auto const n = ::read(fd_.fd_, dest, size);
+#endif
+      if (n == -1 && errno == EINTR) {
+        continue;
+      }
+      utl::verify(n != -1, "stream read error: {}", std::strerror(errno));
+      return static_cast<std::size_t>(n);
+    }
+  }
+
+  static int open_file(char const* path) {
+#ifdef _WIN32
+    auto const fd = _open(path, _O_RDONLY | _O_BINARY);
+#else
+    auto const fd = open(path, O_RDONLY | O_CLOEXEC);
+#endif
+    utl::verify(fd != -1, "unable to open file {}: {}", path,
+                std::strerror(errno));
+    return fd;
+  }
+
+  char* data() { return reinterpret_cast<char*>(buf_.data()); }
+
+  file_descriptor fd_;
+  buffer buf_;
+  std::size_t begin_{0U}, end_{0U};
+  bool eof_{false};
+};
+
+}  // namespace utl
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <limits>
+
+#include "utl/parser/simd_scanner.h"
+
+namespace utl {
+
+constexpr auto const kStringNotFound = std::numeric_limits<std::size_t>::max();
+
+// ' ', '\t', '\n' and '\r'.
+constexpr bool is_space_char(char const c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+constexpr char to_lower_ascii(char const c) {
+  return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+namespace detail {
+
+#ifdef UTL_SIMD_SSE2
+// Bit i is set if byte i of the 16 bytes at p is whitespace.
+inline unsigned space_mask_sse2(char const* p) {
+  auto const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+  auto const eq = [&](char const c) {
+    return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+  };
+  return static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(
+      _mm_or_si128(eq(' '), eq('\t')), _mm_or_si128(eq('\n'), eq('\r')))));
+}
+
+// Sets bit 5 of all bytes in ['A', 'Z'].
+inline __m128i to_lower_sse2(__m128i const v) {
+  auto const upper =
+      _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+                    _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), v));
+  return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+#endif
+
+// Start of the maximal suffix of x[0, m) and its period. With reverse set,
+// the maximal suffix for the reversed byte order.
+inline std::ptrdiff_t max_suffix(unsigned char const* x, std::ptrdiff_t const m,
+                                 std::ptrdiff_t& period, bool const reverse) {
+  auto ms = std::ptrdiff_t{-1};
+  auto j = std::ptrdiff_t{0};
+  auto k = std::ptrdiff_t{1};
+  period = 1;
+  while (j + k < m) {
+    auto const a = x[j + k];
+    auto const b = x[ms + k];
+    if (a == b) {
+      if (k == period) {
+        j += period;
+        k = 1;
+      } else {
+        ++k;
+      }
+    } else if ((a < b) != reverse) {
+      j += k;
+      k = 1;
+      period = j - ms;
+    } else {
+      ms = j;
+      j = ms + 1;
+      k = period = 1;
+    }
+  }
+  return ms;
+}
+
+// Two-Way string matching (Crochemore, Perrin): O(n + m) time, O(1) space.
+inline std::size_t two_way_find(char const* s, std::size_t const n,
+                                char const* needle, std::size_t const m) {
+  if (m > n) {
+    return kStringNotFound;
+  }
+  auto const y = reinterpret_cast<unsigned char const*>(s);
+  auto const x = reinterpret_cast<unsigned char const*>(needle);
+  auto const sm = static_cast<std::ptrdiff_t>(m);
+  auto const last_start = static_cast<std::ptrdiff_t>(n - m);
+
+  std::ptrdiff_t p, q;
+  auto const i = max_suffix(x, sm, p, false);
+  auto const j = max_suffix(x, sm, q, true);
+  auto const ell = i > j ? i : j;
+  auto per = i > j ? p : q;
+
+  if (std::memcmp(x, x + per, static_cast<std::size_t>(ell + 1)) == 0) {
+    // Periodic needle: remember the prefix already matched after a shift.
+    auto memory = std::ptrdiff_t{-1};
+    for (auto pos = std::ptrdiff_t{0}; pos <= last_start;) {
+      auto k = std::max(ell, memory) + 1;
+      while (k < sm && x[k] == y[pos + k]) {
+        ++k;
+      }
+      if (k < sm) {
+        pos += k - ell;
+        memory = -1;
+        continue;
+      }
+      k = ell;
+      while (k > memory && x[k] == y[pos + k]) {
+        --k;
+      }
+      if (k <= memory) {
+        return static_cast<std::size_t>(pos);
+      }
+      pos += per;
+      memory = sm - per - 1;
+    }
+  } else {
+    per = std::max(ell + 1, sm - ell - 1) + 1;
+    for (auto pos = std::ptrdiff_t{0}; pos <= last_start;) {
+      auto k = ell + 1;
+      while (k < sm && x[k] == y[pos + k]) {
+        ++k;
+      }
+      if (k < sm) {
+        pos += k - ell;
+        continue;
+      }
+      k = ell;
+      while (k >= 0 && x[k] == y[pos + k]) {
+        --k;
+      }
+      if (k < 0) {
+        return static_cast<std::size_t>(pos);
+      }
+      pos += per;
+    }
+  }
+  return kStringNotFound;
+}
+
+}  // namespace detail
+
+// Index of the first byte that is not whitespace, n if there is none.
+inline std::size_t find_first_non_space(char const* s, std::size_t const n) {
+  auto i = std::size_t{0U};
+#ifdef UTL_SIMD_SSE2
+  for (; i + 16U <= n; i += 16U) {
+    if (auto const m = detail::space_mask_sse2(s + i) ^ 0xFFFFU; m != 0U) {
+      return i + trailing_zeros(m);
+    }
+  }
+#endif
+  while (i != n && is_space_char(s[i])) {
+    ++i;
+  }
+  return i;
+}
+
+// Length of s without trailing whitespace.
+inline std::size_t find_last_non_space(char const* s, std::size_t n) {
+#ifdef UTL_SIMD_SSE2
+  for (; n >= 16U; n -= 16U) {
+    if (auto const m = detail::space_mask_sse2(s + n - 16U) ^ 0xFFFFU;
+        m != 0U) {
+      return n - 16U + highest_bit(m) + 1U;
+    }
+  }
+#endif
+  while (n != 0U && is_space_char(s[n - 1U])) {
+    --n;
+  }
+  return n;
+}
+
+// Offset of the first occurrence of needle in s, kStringNotFound if there
+// is none. Candidate positions are those where both the first and the last
+// byte of the needle match (compared 16 positions at a time), only these
+// are verified with memcmp. Once failed verifications compared more bytes
+// than a few times the text scanned so far (e.g. "aa...a" in "aa...ab"),
+// the rest is searched with Two-Way, so the worst case stays O(n + m).
+inline std::size_t find_substr(char const* s, std::size_t const n,
+                               char const* needle, std::size_t const m) {
+  if (m == 0U) {
+    return 0U;
+  } else if (m > n) {
+    return kStringNotFound;
+  } else if (m == 1U) {
+    auto const p = static_cast<char const*>(std::memchr(s, needle[0], n));
+    return p == nullptr ? kStringNotFound : static_cast<std::size_t>(p - s);
+  }
+
+  auto const last_start = n - m;
+  auto verified = std::size_t{0U};
+  auto const over_budget = [&](std::size_t const pos) {
+    verified += m;
+    return verified > 4U * pos + 1024U;
+  };
+  auto const two_way_from = [&](std::size_t const pos) {
+    auto const found = detail::two_way_find(s + pos, n - pos, needle, m);
+    return found == kStringNotFound ? kStringNotFound : pos + found;
+  };
+
+  auto i = std::size_t{0U};
+#ifdef UTL_SIMD_SSE2
+  auto const first = _mm_set1_epi8(needle[0]);
+  auto const last = _mm_set1_epi8(needle[m - 1U]);
+  for (; i + 16U <= last_start + 1U; i += 16U) {
+    auto const a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(s + i));
+    auto const b =
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(s + i + m - 1U));
+    auto mask = static_cast<unsigned>(_mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last))));
+    for (; mask != 0U; mask &= mask - 1U) {
+      auto const pos = i + trailing_zeros(mask);
+      if (std::memcmp(s + pos + 1U, needle + 1U, m - 2U) == 0) {
+        return pos;
+      } else if (over_budget(pos)) {
+        return two_way_from(pos + 1U);
+      }
+    }
+  }
+#endif
+  for (; i <= last_start; ++i) {
+    if (s[i] == needle[0] && s[i + m - 1U] == needle[m - 1U]) {
+      if (std::memcmp(s + i + 1U, needle + 1U, m - 2U) == 0) {
+        return i;
+      } else if (over_budget(i)) {
+        return two_way_from(i + 1U);
+      }
+    }
+  }
+  return kStringNotFound;
+}
+
+// ASCII case-insensitive comparison of n bytes.
+inline bool equals_ignore_case(char const* a, char const* b,
+                               std::size_t const n) {
+  auto i = std::size_t{0U};
+#ifdef UTL_SIMD_SSE2
+  for (; i + 16U <= n; i += 16U) {
+    auto const x = detail::to_lower_sse2(
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(a + i)));
+    auto const y = detail::to_lower_sse2(
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(b + i)));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xFFFF) {
+      return false;
+    }
+  }
+#endif
+  for (; i != n; ++i) {
+    if (to_lower_ascii(a[i]) != to_lower_ascii(b[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace utl
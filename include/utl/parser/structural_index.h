@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+
+#include <limits>
+#include <vector>
+
+#include "utl/parser/cstr.h"
+#include "utl/parser/simd_scanner.h"
+
+namespace utl {
+
+// Bit i of the result is the parity of all bits <= i (in-quote mask).
+inline std::uint64_t prefix_xor(std::uint64_t x) {
+  x ^= x << 1U;
+  x ^= x << 2U;
+  x ^= x << 4U;
+  x ^= x << 8U;
+  x ^= x << 16U;
+  x ^= x << 32U;
+  return x;
+}
+
+// Two pass CSV row splitting:
+//   1) build(): vectorized scan for separators and quotes, quote state is
+//      tracked with a prefix XOR over the quote mask. Only separators outside
+//      of quotes are recorded.
+//   2) for_each_field(): materializes the fields from the recorded offsets.
+//
+// build() can stop early once the first max_fields fields are complete.
+// Fields after those are not reported by for_each_field() then.
+template <char Separator = ','>
+struct structural_index {
+  void build(cstr s, std::size_t const max_fields =
+                         std::numeric_limits<std::size_t>::max()) {
+    s_ = s;
+    separators_.clear();
+    complete_ = true;
+
+    auto in_quote_carry = std::uint64_t{0U};
+    block_masks<2U> masks;
+    for (auto offset = std::size_t{0U}; offset < s.len; offset += kBlockSize) {
+      scan_block<2U>(scan_, s.str + offset, s.len - offset, {Separator, '"'},
+                     masks);
+
+      auto const in_quote = prefix_xor(masks[1]) ^ in_quote_carry;
+      in_quote_carry =
+          static_cast<std::uint64_t>(static_cast<std::int64_t>(in_quote) >> 63);
+
+      for (auto seps = masks[0] & ~in_quote; seps != 0U; seps &= seps - 1U) {
+        separators_.emplace_back(offset + trailing_zeros(seps));
+      }
+
+      if (separators_.size() >= max_fields &&
+          offset + kBlockSize < s.len) {
+        complete_ = false;
+        break;
+      }
+    }
+  }
+
+  std::size_t size() const {
+    return separators_.size() + (complete_ ? 1U : 0U);
+  }
+
+  template <typename Fn>
+  void for_each_field(Fn&& fn) const {
+    auto from = std::size_t{0U};
+    for (auto i = 0U; i != separators_.size(); ++i) {
+      fn(i, unquote(s_.substr(from, separators_[i])));
+      from = separators_[i] + 1U;
+    }
+    if (complete_) {
+      fn(separators_.size(), unquote(strip_cr(s_.substr(from, s_.len))));
+    }
+  }
+
+  static cstr unquote(cstr field) {
+    if (field.len == 0U || field[0] != '"') {
+      return field;
+    }
+    return (field.len >= 2U && field[field.len - 1U] == '"')
+               ? field.substr(1U, field.len - 1U)
+               : field.substr(1U);
+  }
+
+  cstr s_;
+  std::vector<std::size_t> separators_;
+  bool complete_{true};
+  block_scan_fn_t<2U> scan_{get_block_scan_fn<2U>()};
+};
+
+}  // namespace utl
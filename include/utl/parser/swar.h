@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include <limits>
+
+#include "utl/parser/simd_scanner.h"
+
+namespace utl {
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+constexpr auto const kSwarDigits = false;
+#else
+constexpr auto const kSwarDigits = true;
+#endif
+
+// Loads 8 bytes, first byte in the least significant position.
+inline std::uint64_t read8(char const* p) {
+  std::uint64_t val;
+  std::memcpy(&val, p, sizeof(val));
+  return val;
+}
+
+inline bool is_eight_digits(std::uint64_t const val) {
+  return ((val & 0xF0F0F0F0F0F0F0F0ULL) |
+          (((val + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4U)) ==
+         0x3333333333333333ULL;
+}
+
+// Converts eight ASCII digits to their value (first byte = leading digit).
+inline std::uint32_t parse_eight_digits(std::uint64_t val) {
+  constexpr auto const mask = std::uint64_t{0x000000FF000000FFULL};
+  constexpr auto const mul1 = std::uint64_t{0x000F424000000064ULL};
+  constexpr auto const mul2 = std::uint64_t{0x0000271000000001ULL};
+  val -= 0x3030303030303030ULL;
+  val = (val * 10U) + (val >> 8U);
+  val = (((val & mask) * mul1) + (((val >> 16U) & mask) * mul2)) >> 32U;
+  return static_cast<std::uint32_t>(val);
+}
+
+// Number of consecutive ASCII digits at the start (lowest bytes) of val.
+inline unsigned digit_run_length(std::uint64_t const val) {
+  auto const non_digits = ((val + 0x4646464646464646ULL) |
+                           (val - 0x3030303030303030ULL)) &
+                          0x8080808080808080ULL;
+  return non_digits == 0U ? 8U : trailing_zeros(non_digits) / 8U;
+}
+
+// Value of the first n (1 <= n <= 8) digits of val.
+inline std::uint32_t parse_digits_swar(std::uint64_t const val,
+                                       unsigned const n) {
+  auto const shift = 8U * (8U - n);
+  return parse_eight_digits(
+      shift == 0U ? val
+                  : (val << shift) | (0x3030303030303030ULL >> (64U - shift)));
+}
+
+inline constexpr std::uint64_t const kPowersOfTen[] = {
+    1ULL,        10ULL,        100ULL,        1000ULL,       10000ULL,
+    100000ULL,   1000000ULL,   10000000ULL,   100000000ULL,  1000000000ULL};
+
+// Accumulates all leading digits in [p, end) into w, up to 8 per step.
+// Returns the position of the first non-digit.
+template <bool CheckOverflow = false>
+char const* parse_digits(char const* p, char const* end, std::uint64_t& w,
+                         bool* overflow = nullptr) {
+  auto const append = [&](std::uint64_t const x, unsigned const n) {
+    if constexpr (CheckOverflow) {
+      if (w > (std::numeric_limits<std::uint64_t>::max() - x) /
+                  kPowersOfTen[n]) {
+        *overflow = true;
+      }
+    }
+    w = w * kPowersOfTen[n] + x;
+  };
+
+  if constexpr (kSwarDigits) {
+    while (end - p >= 8) {
+      auto const val = read8(p);
+      auto const n = digit_run_length(val);
+      if (n == 0U) {
+        return p;
+      }
+      append(parse_digits_swar(val, n), n);
+      p += n;
+      if (n != 8U) {
+        return p;
+      }
+    }
+  }
+  for (; p != end && static_cast<unsigned char>(*p - '0') < 10U; ++p) {
+    append(static_cast<std::uint64_t>(*p - '0'), 1U);
+  }
+  return p;
+}
+
+}  // namespace utl
@@ -1,11 +1,15 @@
 #include "utl/pipes/accumulate.h"
 #include "utl/pipes/all.h"
 #include "utl/pipes/avg.h"
+#include "utl/pipes/batch.h"
 #include "utl/pipes/count.h"
+#include "utl/pipes/count_by.h"
+#include "utl/pipes/distinct.h"
 #include "utl/pipes/emplace_back.h"
 #include "utl/pipes/find.h"
 #include "utl/pipes/for_each.h"
 #include "utl/pipes/generate.h"
+#include "utl/pipes/group_by.h"
 #include "utl/pipes/insert.h"
 #include "utl/pipes/iota.h"
 #include "utl/pipes/is_range.h"
@@ -13,9 +17,15 @@
 #include "utl/pipes/make_range.h"
 #include "utl/pipes/map.h"
 #include "utl/pipes/max.h"
+#include "utl/pipes/mean_var.h"
+#include "utl/pipes/min_max.h"
+#include "utl/pipes/par.h"
+#include "utl/pipes/quantiles.h"
 #include "utl/pipes/remove_if.h"
+#include "utl/pipes/size_hint.h"
 #include "utl/pipes/sum.h"
 #include "utl/pipes/take_while.h"
+#include "utl/pipes/top_k.h"
 #include "utl/pipes/transform.h"
 #include "utl/pipes/unique.h"
 #include "utl/pipes/vec.h"
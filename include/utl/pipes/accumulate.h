@@ -1,19 +1,53 @@
 #pragma once
 
+#include <type_traits>
 #include <utility>
 
+#include "utl/pipes/is_par_range.h"
 #include "utl/pipes/make_range.h"
 
 namespace utl {
 
-template <typename AccumulateFn, typename Acc>
+namespace detail {
+struct no_merge {};
+}  // namespace detail
+
+// In a parallel pipeline (see par.h), every chunk starts with a copy of acc
+// (which therefore has to be the identity of merge) and the chunk results
+// are combined with merge(Acc& into, Acc&& from).
+template <typename AccumulateFn, typename Acc, typename MergeFn = detail::no_merge>
 struct accumulate_t {
   accumulate_t(AccumulateFn&& f, Acc&& acc)
       : fn_(std::forward<AccumulateFn>(f)), acc_(std::forward<Acc>(acc)) {}
 
+  accumulate_t(AccumulateFn&& f, Acc&& acc, MergeFn&& merge)
+      : fn_(std::forward<AccumulateFn>(f)),
+        acc_(std::forward<Acc>(acc)),
+        merge_(std::forward<MergeFn>(merge)) {}
+
   template <typename T>
   friend Acc operator|(T&& t, accumulate_t&& f) {
     auto r = make_range(std::forward<T>(t));
+    if constexpr (is_par_range_v<decltype(r)>) {
+      static_assert(!std::is_same_v<MergeFn, detail::no_merge>,
+                    "parallel accumulate needs a merge function");
+      if (r.par_active_) {
+        f.acc_ = par_reduce(
+            r,
+            [&](auto& sub) {
+              auto acc = clear_t<Acc>{f.acc_};
+              auto it = sub.begin();
+              while (sub.valid(it)) {
+                acc = f.fn_(std::move(acc), sub.read(it));
+                sub.next(it);
+              }
+              return acc;
+            },
+            f.merge_);
+        return f.acc_;
+      }
+    }
+
     auto it = r.begin();
     while (r.valid(it)) {
       f.acc_ = f.fn_(std::forward<Acc>(f.acc_), r.read(it));
@@ -24,6 +58,7 @@ struct accumulate_t {
 
   AccumulateFn fn_;
   Acc acc_;
+  MergeFn merge_;
 };
 
 template <typename AccumulateFn, typename Acc>
@@ -32,4 +67,13 @@ accumulate_t<AccumulateFn, Acc> accumulate(AccumulateFn&& f, Acc&& acc) {
                                          std::forward<Acc>(acc));
 }
 
+template <typename AccumulateFn, typename Acc, typename MergeFn>
+accumulate_t<AccumulateFn, Acc, MergeFn> accumulate(AccumulateFn&& f,
+                                                    Acc&& acc,
+                                                    MergeFn&& merge) {
+  return accumulate_t<AccumulateFn, Acc, MergeFn>(
+      std::forward<AccumulateFn>(f), std::forward<Acc>(acc),
+      std::forward<MergeFn>(merge));
+}
+
 }  // namespace utl
\ No newline at end of file
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstddef>
+
 #include <initializer_list>
+#include <iterator>
 #include <utility>
 
 #include "utl/clear_t.h"
@@ -32,6 +35,9 @@ struct holding_range {
   using it_t = typename Container::const_iterator;
   using begin_t = typename Container::const_iterator;
   using end_t = typename Container::const_iterator;
+  using batch_range_t = holding_range;
+  using size_hint_range_t = holding_range;
+  using exact_size_range_t = holding_range;
 
   explicit holding_range(Container&& c) : c_{std::forward<decltype(c)>(c)} {}
 
@@ -62,6 +68,16 @@ struct holding_range {
     return it != end();
   }
 
+  std::size_t size_hint() const {
+    return static_cast<std::size_t>(std::distance(begin(), end()));
+  }
+
+  template <typename It>
+  std::size_t read_batch(It& it, result_t* out,
+                         std::size_t const max_n) const {
+    return range<It, It>::read_batch(it, end(), out, max_n);
+  }
+
   std::decay_t<Container> c_;
 };
 
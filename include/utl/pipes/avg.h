@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstddef>
+
 #include <utility>
 
+#include "utl/pipes/is_par_range.h"
 #include "utl/pipes/make_range.h"
 
 namespace utl {
@@ -9,18 +12,35 @@ namespace utl {
 struct avg {
   template <typename T>
   friend double operator|(T&& t, avg&& f) {
-    auto r = make_range(std::forward<T>(t));
-    auto it = r.begin();
-    while (r.valid(it)) {
-      f.sum_ += r.read(it);
-      ++f.count_;
-      r.next(it);
+    auto&& r = make_range(std::forward<T>(t));
+    using partial_t = std::pair<decltype(f.sum_), decltype(f.count_)>;
+    auto const run = [](auto& range, partial_t p) {
+      auto it = range.begin();
+      while (range.valid(it)) {
+        p.first += range.read(it);
+        ++p.second;
+        range.next(it);
+      }
+      return p;
+    };
+    auto result = partial_t{f.sum_, f.count_};
+    if constexpr (is_par_range_v<decltype(r)>) {
+      if (r.par_active_) {
+        result = par_reduce(
+            r, [&](auto& sub) { return run(sub, partial_t{}); },
+            [](partial_t& a, partial_t const& b) {
+              a.first += b.first;
+              a.second += b.second;
+            });
+        return result.first / static_cast<double>(result.second);
+      }
     }
-    return f.sum_ / static_cast<double>(f.count_);
+    result = run(r, result);
+    return result.first / static_cast<double>(result.second);
   }
 
-  int sum_ = 0;
-  int count_ = 0;
+  double sum_ = 0.0;
+  std::size_t count_ = 0U;
 };
 
 }  // namespace utl
\ No newline at end of file
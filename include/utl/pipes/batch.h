@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+
+#include <array>
+#include <type_traits>
+
+#include "utl/clear_t.h"
+
+namespace utl {
+
+// Batch buffers live on the stack (one per type changing stage), so their
+// size is limited in bytes, not elements. Element types larger than
+// kPipeBatchMaxElementSize do not use the protocol.
+constexpr auto const kPipeBatchBytes = std::size_t{4096U};
+constexpr auto const kPipeBatchMaxElementSize = std::size_t{64U};
+
+template <typename T>
+constexpr auto const pipe_batch_size_v = kPipeBatchBytes / sizeof(T);
+
+// Optional block protocol next to begin/valid/read/next:
+//   std::size_t read_batch(It& it, result_t* out, std::size_t max_n)
+// writes up to max_n elements to out, advances it past them and returns
+// the number written (0 = end of range).
+//
+// A stage opts in with `using batch_range_t = <own type>`. Since stages
+// derive from their parent, a stage that does not declare it inherits the
+// parent's batch_range_t, which does not match and disables the protocol
+// for it and everything downstream.
+template <typename Range, typename = void>
+struct is_batch_range : std::false_type {};
+
+template <typename Range>
+struct is_batch_range<Range, std::void_t<typename Range::batch_range_t>>
+    : std::bool_constant<
+          std::is_same_v<typename Range::batch_range_t, Range> &&
+          std::is_trivial_v<typename Range::result_t> &&
+          sizeof(typename Range::result_t) <= kPipeBatchMaxElementSize> {};
+
+template <typename Range>
+constexpr auto const is_batch_range_v = is_batch_range<clear_t<Range>>::value;
+
+// Calls fn(result_t const* data, std::size_t n) for every batch of r.
+template <typename Range, typename Fn>
+void for_each_batch(Range& r, Fn&& fn) {
+  using result_t = typename clear_t<Range>::result_t;
+  std::array<result_t, pipe_batch_size_v<result_t>> buf;
+  auto it = r.begin();
+  while (true) {
+    auto const n = r.read_batch(it, buf.data(), buf.size());
+    if (n == 0U) {
+      return;
+    }
+    fn(static_cast<result_t const*>(buf.data()), n);
+  }
+}
+
+}  // namespace utl
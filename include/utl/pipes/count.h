@@ -1,7 +1,11 @@
 #pragma once
 
+#include <type_traits>
 #include <utility>
 
+#include "utl/clear_t.h"
+#include "utl/pipes/batch.h"
+#include "utl/pipes/is_par_range.h"
 #include "utl/pipes/make_range.h"
 
 namespace utl {
@@ -13,14 +17,32 @@ struct count_t {
   template <typename T>
   friend auto operator|(T&& t, count_t&& f) {
     auto r = make_range(std::forward<T>(t));
-    auto it = r.begin();
-
-    while (r.valid(it)) {
-      f.count_ += (f.fn_(r.read(it)) ? 1 : 0);
-      r.next(it);
+    auto const run = [&](auto& range, std::size_t count) {
+      using result_t = typename clear_t<decltype(range)>::result_t;
+      if constexpr (is_batch_range_v<decltype(range)> &&
+                    std::is_invocable_v<CountFn&, result_t const&>) {
+        for_each_batch(range, [&](auto const* batch, std::size_t const n) {
+          for (auto i = std::size_t{0U}; i != n; ++i) {
+            count += (f.fn_(batch[i]) ? 1U : 0U);
+          }
+        });
+      } else {
+        auto it = range.begin();
+        while (range.valid(it)) {
+          count += (f.fn_(range.read(it)) ? 1 : 0);
+          range.next(it);
+        }
+      }
+      return count;
+    };
+    if constexpr (is_par_range_v<decltype(r)>) {
+      if (r.par_active_) {
+        return par_reduce(
+            r, [&](auto& sub) { return run(sub, std::size_t{0U}); },
+            [](std::size_t& a, std::size_t const b) { a += b; });
+      }
     }
-
-    return f.count_;
+    return run(r, f.count_);
   }
 
   std::size_t count_{0};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+
+#include <utility>
+#include <vector>
+
+#include "utl/clear_t.h"
+#include "utl/hash_index.h"
+#include "utl/pipes/is_par_range.h"
+#include "utl/pipes/make_range.h"
+
+namespace utl {
+
+namespace detail {
+
+template <typename Key>
+struct count_by_state {
+  template <typename K>
+  void add(K&& key, std::size_t const n) {
+    auto const [idx, inserted] = index_.insert(std::forward<K>(key));
+    if (inserted) {
+      counts_.emplace_back(0U);
+    }
+    counts_[idx] += n;
+  }
+
+  std::vector<std::pair<Key, std::size_t>> to_vec() {
+    auto v = std::vector<std::pair<Key, std::size_t>>{};
+    v.reserve(counts_.size());
+    for (auto i = std::size_t{0U}; i != counts_.size(); ++i) {
+      v.emplace_back(std::move(index_.keys_[i]), counts_[i]);
+    }
+    return v;
+  }
+
+  hash_index<Key> index_;
+  std::vector<std::size_t> counts_;
+};
+
+}  // namespace detail
+
+// Counts the elements per key_fn(element) in one pass (no sort).
+// Returns (key, count) pairs in order of the first occurrence of each key.
+template <typename KeyFn>
+struct count_by_t {
+  explicit count_by_t(KeyFn&& f) : fn_(std::forward<KeyFn>(f)) {}
+
+  template <typename T>
+  friend auto operator|(T&& t, count_by_t&& f) {
+    auto r = make_range(std::forward<T>(t));
+    using key_t = clear_t<decltype(f.fn_(
+        std::declval<typename clear_t<decltype(r)>::result_t>()))>;
+    using state_t = detail::count_by_state<key_t>;
+
+    auto const run = [&](auto& range) {
+      auto state = state_t{};
+      auto it = range.begin();
+      while (range.valid(it)) {
+        state.add(f.fn_(range.read(it)), 1U);
+        range.next(it);
+      }
+      return state;
+    };
+    if constexpr (is_par_range_v<decltype(r)>) {
+      if (r.par_active_) {
+        return par_reduce(r, run,
+                          [](state_t& a, state_t&& b) {
+                            for (auto i = std::size_t{0U};
+                                 i != b.counts_.size(); ++i) {
+                              a.add(std::move(b.index_.keys_[i]),
+                                    b.counts_[i]);
+                            }
+                          })
+            .to_vec();
+      }
+    }
+    return run(r).to_vec();
+  }
+
+  KeyFn fn_;
+};
+
+template <typename KeyFn>
+count_by_t<KeyFn> count_by(KeyFn&& f) {
+  return count_by_t<KeyFn>(std::forward<KeyFn>(f));
+}
+
+}  // namespace utl
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <utility>
+
+#include "utl/clear_t.h"
+#include "utl/hash_index.h"
+#include "utl/pipes/make_range.h"
+
+namespace utl {
+
+// Like unique(), but removes all repeated elements (not only consecutive
+// ones) in one pass and keeps the order of first occurrence. Its state
+// spans the whole range, so it is not chunkable after par().
+template <typename Range>
+struct distinct_range : public clear_t<Range> {
+  using parent_t = clear_t<Range>;
+  using result_t = typename parent_t::result_t;
+
+  template <typename T>
+  explicit distinct_range(T&& r) : parent_t(std::forward<T>(r)) {}
+
+  template <typename It>
+  void find(It& it) {
+    while (this->valid(it) && !seen_.insert(parent_t::read(it)).second) {
+      parent_t::next(it);
+    }
+  }
+
+  template <typename It>
+  void next(It& it) {
+    parent_t::next(it);
+    find(it);
+  }
+
+  auto begin() {
+    auto it = parent_t::begin();
+    find(it);
+    return it;
+  }
+
+  hash_index<result_t> seen_;
+};
+
+struct distinct_t {
+  template <typename T>
+  friend auto operator|(T&& r, distinct_t&&) {
+    return distinct_range<T>(std::forward<T>(r));
+  }
+};
+
+inline distinct_t distinct() { return distinct_t(); }
+
+template <typename Range>
+struct is_range<distinct_range<Range>> : std::true_type {};
+
+}  // namespace utl
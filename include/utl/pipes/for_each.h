@@ -2,6 +2,7 @@
 
 #include <utility>
 
+#include "utl/pipes/is_par_range.h"
 #include "utl/pipes/make_range.h"
 
 namespace utl {
@@ -12,11 +13,21 @@ struct for_each_t {
 
   template <typename T>
   friend void operator|(T&& r, for_each_t&& f) {
-    auto it = r.begin();
-    while (r.valid(it)) {
-      f.fn_(r.read(it));
-      r.next(it);
+    auto const run = [&](auto& range) {
+      auto it = range.begin();
+      while (range.valid(it)) {
+        f.fn_(range.read(it));
+        range.next(it);
+      }
+      return true;
+    };
+    if constexpr (is_par_range_v<T>) {
+      if (r.par_active_) {
+        par_reduce(r, run, [](bool&, bool) {});
+        return;
+      }
     }
+    run(r);
   }
 
   ForEachFn fn_;
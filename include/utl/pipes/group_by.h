@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstddef>
+
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "utl/clear_t.h"
+#include "utl/hash_index.h"
+#include "utl/pipes/accumulate.h"
+#include "utl/pipes/is_par_range.h"
+#include "utl/pipes/make_range.h"
+
+namespace utl {
+
+namespace detail {
+
+struct collect_group {};
+
+template <typename Key, typename Acc>
+struct group_by_state {
+  template <typename K, typename Init>
+  Acc& get(K&& key, Init&& init) {
+    auto const [idx, inserted] = index_.insert(std::forward<K>(key));
+    if (inserted) {
+      groups_.emplace_back(init());
+    }
+    return groups_[idx];
+  }
+
+  std::vector<std::pair<Key, Acc>> to_vec() {
+    auto v = std::vector<std::pair<Key, Acc>>{};
+    v.reserve(groups_.size());
+    for (auto i = std::size_t{0U}; i != groups_.size(); ++i) {
+      v.emplace_back(std::move(index_.keys_[i]), std::move(groups_[i]));
+    }
+    return v;
+  }
+
+  hash_index<Key> index_;
+  std::vector<Acc> groups_;
+};
+
+}  // namespace detail
+
+// Groups the elements by key_fn(element) in one pass (no sort) and
+// returns (key, group) pairs in order of the first occurrence of each key.
+// Without an aggregate function, a group is the vector of its elements.
+// Otherwise it is acc = agg_fn(std::move(acc), element), starting from a
+// copy of init (see accumulate). After par(), collected groups are
+// concatenated in chunk order, aggregates need merge(Acc& into, Acc&& from).
+template <typename KeyFn, typename AggFn, typename Acc,
+          typename MergeFn = detail::no_merge>
+struct group_by_t {
+  group_by_t(KeyFn&& key_fn, AggFn&& agg_fn, Acc&& init)
+      : key_fn_(std::forward<KeyFn>(key_fn)),
+        agg_fn_(std::forward<AggFn>(agg_fn)),
+        init_(std::forward<Acc>(init)) {}
+
+  group_by_t(KeyFn&& key_fn, AggFn&& agg_fn, Acc&& init, MergeFn&& merge)
+      : key_fn_(std::forward<KeyFn>(key_fn)),
+        agg_fn_(std::forward<AggFn>(agg_fn)),
+        init_(std::forward<Acc>(init)),
+        merge_(std::forward<MergeFn>(merge)) {}
+
+  template <typename T>
+  friend auto operator|(T&& t, group_by_t&& f) {
+    auto r = make_range(std::forward<T>(t));
+    using value_t = typename clear_t<decltype(r)>::result_t;
+    using key_t =
+        clear_t<decltype(f.key_fn_(std::declval<value_t const&>()))>;
+    constexpr auto const collect =
+        std::is_same_v<clear_t<Acc>, detail::collect_group>;
+    using acc_t =
+        std::conditional_t<collect, std::vector<value_t>, clear_t<Acc>>;
+    using state_t = detail::group_by_state<key_t, acc_t>;
+
+    auto const init = [&]() {
+      if constexpr (collect) {
+        return acc_t{};
+      } else {
+        return acc_t{f.init_};
+      }
+    };
+    auto const run = [&](auto& range) {
+      auto state = state_t{};
+      auto it = range.begin();
+      while (range.valid(it)) {
+        auto&& value = range.read(it);
+        auto& acc = state.get(f.key_fn_(value), init);
+        if constexpr (collect) {
+          acc.emplace_back(value);
+        } else {
+          acc = f.agg_fn_(std::move(acc), value);
+        }
+        range.next(it);
+      }
+      return state;
+    };
+
+    if constexpr (is_par_range_v<decltype(r)>) {
+      static_assert(collect || !std::is_same_v<MergeFn, detail::no_merge>,
+                    "parallel group_by with aggregate needs a merge function");
+      if (r.par_active_) {
+        return par_reduce(r, run,
+                          [&](state_t& a, state_t&& b) {
+                            for (auto i = std::size_t{0U};
+                                 i != b.groups_.size(); ++i) {
+                              auto& acc =
+                                  a.get(std::move(b.index_.keys_[i]), init);
+                              if constexpr (collect) {
+                                acc.insert(end(acc),
+                                           std::make_move_iterator(
+                                               begin(b.groups_[i])),
+                                           std::make_move_iterator(
+                                               end(b.groups_[i])));
+                              } else {
+                                f.merge_(acc, std::move(b.groups_[i]));
+                              }
+                            }
+                          })
+            .to_vec();
+      }
+    }
+    return run(r).to_vec();
+  }
+
+  KeyFn key_fn_;
+  AggFn agg_fn_;
+  Acc init_;
+  MergeFn merge_;
+};
+
+template <typename KeyFn>
+group_by_t<KeyFn, detail::collect_group, detail::collect_group> group_by(
+    KeyFn&& key_fn) {
+  return {std::forward<KeyFn>(key_fn), detail::collect_group{},
+          detail::collect_group{}};
+}
+
+template <typename KeyFn, typename AggFn, typename Acc>
+group_by_t<KeyFn, AggFn, Acc> group_by(KeyFn&& key_fn, AggFn&& agg_fn,
+                                       Acc&& init) {
+  return {std::forward<KeyFn>(key_fn), std::forward<AggFn>(agg_fn),
+          std::forward<Acc>(init)};
+}
+
+template <typename KeyFn, typename AggFn, typename Acc, typename MergeFn>
+group_by_t<KeyFn, AggFn, Acc, MergeFn> group_by(KeyFn&& key_fn,
+                                                AggFn&& agg_fn, Acc&& init,
+                                                MergeFn&& merge) {
+  return {std::forward<KeyFn>(key_fn), std::forward<AggFn>(agg_fn),
+          std::forward<Acc>(init), std::forward<MergeFn>(merge)};
+}
+
+}  // namespace utl
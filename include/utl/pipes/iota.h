@@ -1,5 +1,10 @@
 #pragma once
 
+#include <cstddef>
+
+#include <algorithm>
+#include <type_traits>
+
 #include "utl/pipes/make_range.h"
 
 #include "utl/clear_t.h"
@@ -9,6 +14,12 @@ namespace utl {
 template <typename FromIntType, typename ToIntType>
 struct iota_range {
   using result_t = FromIntType;
+  using batch_range_t = iota_range;
+  using size_hint_range_t =
+      std::conditional_t<std::is_integral_v<FromIntType> &&
+                             std::is_integral_v<ToIntType>,
+                         iota_range, void>;
+  using exact_size_range_t = size_hint_range_t;
 
   struct end_it {};
 
@@ -39,6 +50,32 @@ struct iota_range {
     ++it.val_;
   }
 
+  std::size_t size_hint() const {
+    return from_ < to_ ? static_cast<std::size_t>(to_ - from_) : 0U;
+  }
+
+  template <typename It>
+  std::size_t read_batch(It& it, result_t* out, std::size_t const max_n) {
+    if constexpr (std::is_integral_v<FromIntType> &&
+                  std::is_integral_v<ToIntType>) {
+      auto const n =
+          it.val_ < to_
+              ? std::min(max_n, static_cast<std::size_t>(to_ - it.val_))
+              : std::size_t{0U};
+      for (auto i = std::size_t{0U}; i != n; ++i) {
+        out[i] = static_cast<FromIntType>(it.val_ + static_cast<FromIntType>(i));
+      }
+      it.val_ = static_cast<FromIntType>(it.val_ + static_cast<FromIntType>(n));
+      return n;
+    } else {
+      auto n = std::size_t{0U};
+      for (; n != max_n && valid(it); next(it)) {
+        out[n++] = it.val_;
+      }
+      return n;
+    }
+  }
+
   FromIntType from_;
   ToIntType to_;
 };
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+
+#include <algorithm>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "utl/clear_t.h"
+
+namespace utl {
+
+struct thread_pool;
+
+// Base of par_range (see par.h). All stages derive from their parent range,
+// so every stage downstream of par() is a par_base, too.
+struct par_base {
+  thread_pool* pool_{nullptr};
+  std::size_t chunk_size_{0U};  // 0 = four chunks per pool thread
+  bool par_active_{true};  // false for the per chunk copies
+};
+
+template <typename Range>
+constexpr auto const is_par_range_v =
+    std::is_base_of_v<par_base, clear_t<Range>>;
+
+// Stages that can run independently per chunk (no state across elements)
+// opt in by naming themselves in par_range_t, like batch_range_t (see
+// batch.h). Stateful stages (unique, distinct, take_while, ...) inherit
+// their parent's tag, which does not match, so par_reduce rejects them.
+template <typename Range, typename = void>
+struct is_chunkable : std::false_type {};
+
+template <typename Range>
+struct is_chunkable<Range, std::void_t<typename Range::par_range_t>>
+    : std::is_same<typename Range::par_range_t, Range> {};
+
+template <typename Range>
+constexpr auto const is_chunkable_v = is_chunkable<clear_t<Range>>::value;
+
+// Runs run(sub) for chunks of the source on the thread pool, where sub is
+// a copy of the pipeline r restricted to one chunk. The results are
+// combined in chunk order with merge(into, from), so merge only has to be
+// associative.
+template <typename Range, typename Run, typename Merge>
+auto par_reduce(Range const& r, Run&& run, Merge&& merge) {
+  using range_t = clear_t<Range>;
+  using result_t = clear_t<decltype(run(std::declval<range_t&>()))>;
+  static_assert(is_chunkable_v<range_t>,
+                "par: a stage after par() keeps state across elements and "
+                "cannot run per chunk");
+
+  auto const n = r.par_source_size();
+  auto const n_threads = std::max(std::size_t{1U}, r.pool_->size());
+  auto const chunk_size =
+      r.chunk_size_ != 0U
+          ? r.chunk_size_
+          : std::max(std::size_t{1U}, (n + 4U * n_threads - 1U) /
+                                          (4U * n_threads));
+  auto const n_chunks =
+      std::max(std::size_t{1U}, (n + chunk_size - 1U) / chunk_size);
+
+  auto results = std::vector<std::optional<result_t>>(n_chunks);
+  r.pool_->execute(n_chunks, [&](std::size_t const i) {
+    auto sub = r;
+    sub.par_restrict(std::min(n, i * chunk_size),
+                     std::min(n, (i + 1U) * chunk_size));
+    results[i].emplace(run(sub));
+  });
+
+  auto result = std::move(*results[0]);
+  for (auto i = std::size_t{1U}; i < n_chunks; ++i) {
+    merge(result, std::move(*results[i]));
+  }
+  return result;
+}
+
+}  // namespace utl
@@ -2,6 +2,7 @@
 
 #include <utility>
 
+#include "utl/pipes/is_par_range.h"
 #include "utl/pipes/make_range.h"
 
 namespace utl {
@@ -11,14 +12,22 @@ struct max {
   template <typename T>
   friend double operator|(T&& t, max&& f) {
     auto r = make_range(std::forward<T>(t));
-    auto it = r.begin();
-
-    while (r.valid(it)) {
-      f.max_ = std::max(f.max_, r.read(it));
-      r.next(it);
+    auto const run = [](auto& range, MaxType max) {
+      auto it = range.begin();
+      while (range.valid(it)) {
+        max = std::max(max, range.read(it));
+        range.next(it);
+      }
+      return max;
+    };
+    if constexpr (is_par_range_v<decltype(r)>) {
+      if (r.par_active_) {
+        return par_reduce(
+            r, [&](auto& sub) { return run(sub, f.max_); },
+            [](MaxType& a, MaxType const& b) { a = std::max(a, b); });
+      }
     }
-
-    return f.max_;
+    return run(r, f.max_);
   }
 
   MaxType max_;
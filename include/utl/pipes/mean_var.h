@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+
+#include <utility>
+
+#include "utl/pipes/is_par_range.h"
+#include "utl/pipes/make_range.h"
+
+namespace utl {
+
+// Numerically stable running mean and variance (Welford). Two partial
+// results are combined with the pairwise formula of Chan et al.
+struct mean_var_result {
+  void add(double const x) {
+    ++count_;
+    auto const delta = x - mean_;
+    mean_ += delta / static_cast<double>(count_);
+    m2_ += delta * (x - mean_);
+  }
+
+  void merge(mean_var_result const& o) {
+    if (o.count_ == 0U) {
+      return;
+    }
+    auto const n = count_ + o.count_;
+    auto const delta = o.mean_ - mean_;
+    mean_ += delta * static_cast<double>(o.count_) / static_cast<double>(n);
+    m2_ += o.m2_ + delta * delta * static_cast<double>(count_) *
+                       static_cast<double>(o.count_) / static_cast<double>(n);
+    count_ = n;
+  }
+
+  double mean() const { return mean_; }
+  double variance() const {
+    return count_ == 0U ? 0.0 : m2_ / static_cast<double>(count_);
+  }
+  double sample_variance() const {
+    return count_ < 2U ? 0.0 : m2_ / static_cast<double>(count_ - 1U);
+  }
+
+  std::size_t count_{0U};
+  double mean_{0.0};
+  double m2_{0.0};
+};
+
+struct mean_var_t {
+  template <typename T>
+  friend mean_var_result operator|(T&& t, mean_var_t&&) {
+    auto r = make_range(std::forward<T>(t));
+    auto const run = [](auto& range) {
+      auto result = mean_var_result{};
+      auto it = range.begin();
+      while (range.valid(it)) {
+        result.add(static_cast<double>(range.read(it)));
+        range.next(it);
+      }
+      return result;
+    };
+    if constexpr (is_par_range_v<decltype(r)>) {
+      if (r.par_active_) {
+        return par_reduce(r, run,
+                          [](mean_var_result& a, mean_var_result const& b) {
+                            a.merge(b);
+                          });
+      }
+    }
+    return run(r);
+  }
+};
+
+inline mean_var_t mean_var() { return mean_var_t(); }
+
+}  // namespace utl
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <optional>
+#include <utility>
+
+#include "utl/clear_t.h"
+#include "utl/pipes/is_par_range.h"
+#include "utl/pipes/make_range.h"
+
+namespace utl {
+
+// Smallest and largest element in one pass, nullopt for an empty range.
+struct min_max_t {
+  template <typename T>
+  friend auto operator|(T&& t, min_max_t&&) {
+    auto r = make_range(std::forward<T>(t));
+    using value_t = typename clear_t<decltype(r)>::result_t;
+    using result_t = std::optional<std::pair<value_t, value_t>>;
+
+    auto const merge = [](result_t& a, result_t const& b) {
+      if (!b.has_value()) {
+        return;
+      } else if (!a.has_value()) {
+        a = b;
+      } else {
+        if (b->first < a->first) {
+          a->first = b->first;
+        }
+        if (a->second < b->second) {
+          a->second = b->second;
+        }
+      }
+    };
+    auto const run = [&](auto& range) {
+      auto it = range.begin();
+      auto result = result_t{};
+      if (range.valid(it)) {
+        result.emplace(range.read(it), range.read(it));
+        range.next(it);
+      }
+      while (range.valid(it)) {
+        auto&& value = range.read(it);
+        if (value < result->first) {
+          result->first = value;
+        } else if (result->second < value) {
+          result->second = value;
+        }
+        range.next(it);
+      }
+      return result;
+    };
+    if constexpr (is_par_range_v<decltype(r)>) {
+      if (r.par_active_) {
+        return par_reduce(r, run, merge);
+      }
+    }
+    return run(r);
+  }
+};
+
+inline min_max_t min_max() { return min_max_t(); }
+
+}  // namespace utl
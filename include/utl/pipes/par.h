@@ -0,0 +1,149 @@
+#pragma once
+
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "utl/clear_t.h"
+#include "utl/pipes/all.h"
+#include "utl/pipes/batch.h"
+#include "utl/pipes/iota.h"
+#include "utl/pipes/is_par_range.h"
+#include "utl/pipes/is_range.h"
+#include "utl/pipes/size_hint.h"
+#include "utl/thread_pool.h"
+
+namespace utl {
+
+// Random access sources: number of elements and sub range [from, to).
+template <typename It>
+std::size_t par_source_size(range<It, It> const& r) {
+  static_assert(is_random_access_iterator_v<It>,
+                "par: source needs random access iterators");
+  return static_cast<std::size_t>(r.end_ - r.begin_);
+}
+
+template <typename It>
+range<It, It> par_source_slice(range<It, It> const& r, std::size_t const from,
+                               std::size_t const to) {
+  using diff_t = typename std::iterator_traits<It>::difference_type;
+  return {r.begin_ + static_cast<diff_t>(from),
+          r.begin_ + static_cast<diff_t>(to)};
+}
+
+template <typename Container>
+std::size_t par_source_size(holding_range<Container> const& r) {
+  return static_cast<std::size_t>(r.end() - r.begin());
+}
+
+template <typename Container>
+auto par_source_slice(holding_range<Container> const& r,
+                      std::size_t const from, std::size_t const to) {
+  using it_t = typename holding_range<Container>::it_t;
+  using diff_t = typename std::iterator_traits<it_t>::difference_type;
+  return range<it_t, it_t>{r.begin() + static_cast<diff_t>(from),
+                           r.begin() + static_cast<diff_t>(to)};
+}
+
+template <typename From, typename To>
+std::size_t par_source_size(iota_range<From, To> const& r) {
+  return r.to_ > r.from_ ? static_cast<std::size_t>(r.to_ - r.from_) : 0U;
+}
+
+template <typename From, typename To>
+iota_range<From, To> par_source_slice(iota_range<From, To> const& r,
+                                      std::size_t const from,
+                                      std::size_t const to) {
+  return {static_cast<From>(r.from_ + static_cast<From>(from)),
+          static_cast<To>(r.from_ + static_cast<From>(to))};
+}
+
+// Marks the pipeline as parallel. Terminal stages (vec, sum, count, ...)
+// split the source into chunks, run a copy of the pipeline (transform,
+// remove_if) for each chunk on the thread pool and combine the partial
+// results. All functions of the pipeline are called concurrently.
+// Stateful stages (unique, distinct, take_while, ...) do not compile after
+// par(), see is_chunkable.
+//
+// thread_pool::execute is not re-entrant: do not run a par() pipeline from
+// inside a job of the same pool (e.g. in a parallel for_each or
+// parallel_for_each_line body on that pool).
+template <typename Source>
+struct par_range : public par_base {
+  using slice_t = decltype(par_source_slice(std::declval<Source const&>(),
+                                            0U, 0U));
+  using result_t = typename slice_t::result_t;
+  using batch_range_t =
+      std::conditional_t<is_batch_range_v<slice_t>, par_range, void>;
+  using size_hint_range_t = par_range;
+  using par_range_t = par_range;
+  using exact_size_range_t = par_range;
+
+  par_range(Source&& src, thread_pool& pool, std::size_t const chunk_size)
+      : par_base{&pool, chunk_size},
+        src_{std::make_shared<Source const>(std::move(src))},
+        slice_{par_source_slice(*src_, 0U, utl::par_source_size(*src_))} {}
+
+  std::size_t par_source_size() const { return utl::par_source_size(*src_); }
+
+  void par_restrict(std::size_t const from, std::size_t const to) {
+    slice_ = par_source_slice(*src_, from, to);
+    par_active_ = false;
+  }
+
+  std::size_t size_hint() const { return slice_.size_hint(); }
+
+  auto begin() { return slice_.begin(); }
+
+  template <typename It>
+  decltype(auto) read(It& it) const {
+    return slice_.read(it);
+  }
+
+  template <typename It>
+  void next(It& it) {
+    slice_.next(it);
+  }
+
+  template <typename It>
+  bool valid(It& it) {
+    return slice_.valid(it);
+  }
+
+  template <typename It>
+  std::size_t read_batch(It& it, result_t* out, std::size_t const max_n) {
+    return slice_.read_batch(it, out, max_n);
+  }
+
+  std::shared_ptr<Source const> src_;
+  slice_t slice_;
+};
+
+struct par_t {
+  // Containers are taken like in all(): by reference for lvalues,
+  // by value for rvalues.
+  template <typename T>
+  friend auto operator|(T&& r, par_t&& p) {
+    if constexpr (is_range<clear_t<T>>::value) {
+      return par_range<clear_t<T>>{clear_t<T>{std::forward<T>(r)}, *p.pool_,
+                                   p.chunk_size_};
+    } else {
+      auto src = all(std::forward<T>(r));
+      return par_range<decltype(src)>{std::move(src), *p.pool_,
+                                      p.chunk_size_};
+    }
+  }
+
+  thread_pool* pool_;
+  std::size_t chunk_size_;
+};
+
+inline par_t par(thread_pool& pool, std::size_t const chunk_size = 0U) {
+  return {&pool, chunk_size};
+}
+
+template <typename Source>
+struct is_range<par_range<Source>> : std::true_type {};
+
+}  // namespace utl
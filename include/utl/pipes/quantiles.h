@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+#include "utl/clear_t.h"
+#include "utl/pipes/is_par_range.h"
+#include "utl/pipes/make_range.h"
+
+namespace utl {
+
+// KLL quantile sketch (Karnin, Lang, Liberty): level h holds items of
+// weight 2^h. A full level is sorted and every other item (random offset)
+// is promoted to the next level. Lower levels get geometrically smaller
+// capacities, so the memory is O(k) and the rank error roughly O(n / k).
+// Exact as long as nothing was compacted: level 0 holds k items before
+// the first compaction, so for n <= k.
+template <typename T>
+struct quantile_sketch {
+  explicit quantile_sketch(std::size_t const k = 200U) : k_{k} { grow(); }
+
+  void add(T const& value) {
+    levels_.front().emplace_back(value);
+    if (++size_ >= max_size_) {
+      compress();
+    }
+  }
+
+  void merge(quantile_sketch&& o) {
+    while (levels_.size() < o.levels_.size()) {
+      grow();
+    }
+    for (auto h = std::size_t{0U}; h != o.levels_.size(); ++h) {
+      levels_[h].insert(end(levels_[h]), begin(o.levels_[h]),
+                        end(o.levels_[h]));
+      size_ += o.levels_[h].size();
+    }
+    while (size_ >= max_size_) {
+      compress();
+    }
+  }
+
+  // Item of the smallest rank r with r >= p * n for every p in [0, 1].
+  // Empty if no item was added.
+  std::vector<T> query(std::vector<double> const& ps) const {
+    auto weighted = std::vector<std::pair<T, std::uint64_t>>{};
+    auto total = std::uint64_t{0U};
+    for (auto h = std::size_t{0U}; h != levels_.size(); ++h) {
+      for (auto const& value : levels_[h]) {
+        weighted.emplace_back(value, std::uint64_t{1U} << h);
+        total += std::uint64_t{1U} << h;
+      }
+    }
+    if (weighted.empty()) {
+      return {};
+    }
+    std::sort(begin(weighted), end(weighted),
+              [](auto const& a, auto const& b) { return a.first < b.first; });
+
+    auto result = std::vector<T>{};
+    result.reserve(ps.size());
+    for (auto const p : ps) {
+      auto const target = p * static_cast<double>(total);
+      auto rank = std::uint64_t{0U};
+      auto it = begin(weighted);
+      for (; it != end(weighted) - 1; ++it) {
+        rank += it->second;
+        if (static_cast<double>(rank) >= target) {
+          break;
+        }
+      }
+      result.emplace_back(it->first);
+    }
+    return result;
+  }
+
+  std::size_t capacity(std::size_t const h) const {
+    auto const depth = static_cast<double>(levels_.size() - h - 1U);
+    return static_cast<std::size_t>(
+               std::ceil(std::pow(2.0 / 3.0, depth) * static_cast<double>(k_))) +
+           1U;
+  }
+
+  void grow() {
+    levels_.emplace_back();
+    max_size_ = 0U;
+    for (auto h = std::size_t{0U}; h != levels_.size(); ++h) {
+      max_size_ += capacity(h);
+    }
+  }
+
+  void compress() {
+    for (auto h = std::size_t{0U}; h != levels_.size(); ++h) {
+      if (levels_[h].size() < capacity(h)) {
+        continue;
+      }
+      if (h + 1U == levels_.size()) {
+        grow();
+      }
+      auto& level = levels_[h];
+      std::sort(begin(level), end(level));
+      auto const odd = level.size() % 2U == 1U;
+      auto const n = level.size() - (odd ? 1U : 0U);
+      for (auto i = std::size_t{random_bit()}; i < n; i += 2U) {
+        levels_[h + 1U].emplace_back(level[i]);
+      }
+      size_ -= n / 2U;
+      level.erase(begin(level), begin(level) + static_cast<std::ptrdiff_t>(n));
+      if (size_ < max_size_) {
+        return;
+      }
+    }
+  }
+
+  // xorshift64: deterministic, so results are reproducible.
+  unsigned random_bit() {
+    rng_ ^= rng_ << 13U;
+    rng_ ^= rng_ >> 7U;
+    rng_ ^= rng_ << 17U;
+    return static_cast<unsigned>(rng_ >> 63U);
+  }
+
+  std::size_t k_;
+  std::vector<std::vector<T>> levels_;
+  std::size_t size_{0U};
+  std::size_t max_size_{0U};
+  std::uint64_t rng_{0x9E3779B97F4A7C15ULL};
+};
+
+// Approximate quantiles (one result per p in ps) in a single pass with
+// O(k) memory instead of materializing and sorting the range. Exact for
+// ranges of at most k elements.
+struct quantiles_t {
+  template <typename T>
+  friend auto operator|(T&& t, quantiles_t&& f) {
+    auto r = make_range(std::forward<T>(t));
+    using sketch_t = quantile_sketch<typename clear_t<decltype(r)>::result_t>;
+
+    auto const run = [&](auto& range) {
+      auto sketch = sketch_t{f.k_};
+      auto it = range.begin();
+      while (range.valid(it)) {
+        sketch.add(range.read(it));
+        range.next(it);
+      }
+      return sketch;
+    };
+    if constexpr (is_par_range_v<decltype(r)>) {
+      if (r.par_active_) {
+        return par_reduce(r, run,
+                          [](sketch_t& a, sketch_t&& b) {
+                            a.merge(std::move(b));
+                          })
+            .query(f.ps_);
+      }
+    }
+    return run(r).query(f.ps_);
+  }
+
+  std::vector<double> ps_;
+  std::size_t k_;
+};
+
+inline quantiles_t quantiles(std::initializer_list<double> ps,
+                             std::size_t const k = 200U) {
+  return {std::vector<double>{ps}, k};
+}
+
+}  // namespace utl
@@ -1,12 +1,32 @@
 #pragma once
 
+#include <cstddef>
+
+#include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <type_traits>
 #include <utility>
 
 #include "utl/clear_t.h"
 
 namespace utl {
 
+// False for iterators without iterator_category (e.g. hand-rolled ones that
+// only provide *, ++ and !=) instead of a hard error.
+template <typename It, typename = void>
+struct is_random_access_iterator : std::false_type {};
+
+template <typename It>
+struct is_random_access_iterator<
+    It, std::void_t<typename std::iterator_traits<It>::iterator_category>>
+    : std::is_base_of<std::random_access_iterator_tag,
+                      typename std::iterator_traits<It>::iterator_category> {};
+
+template <typename It>
+constexpr auto const is_random_access_iterator_v =
+    is_random_access_iterator<It>::value;
+
 template <typename BeginIt, typename EndIt>
 struct range {
   using result_t = clear_t<decltype(*std::declval<BeginIt>())>;
@@ -14,6 +34,12 @@ struct range {
   using it_t = BeginIt;
   using begin_t = BeginIt;
   using end_t = EndIt;
+  using batch_range_t = range;
+  using size_hint_range_t =
+      std::conditional_t<std::is_same_v<BeginIt, EndIt> &&
+                             is_random_access_iterator_v<BeginIt>,
+                         range, void>;
+  using exact_size_range_t = size_hint_range_t;
 
   range(BeginIt begin, EndIt end)
       : begin_(std::forward<BeginIt>(begin)), end_(std::forward<EndIt>(end)) {}
@@ -45,6 +71,36 @@ struct range {
     return it != end_;
   }
 
+  std::size_t size_hint() const {
+    return static_cast<std::size_t>(end_ - begin_);
+  }
+
+  template <typename It>
+  std::size_t read_batch(It& it, result_t* out,
+                         std::size_t const max_n) const {
+    return read_batch(it, end_, out, max_n);
+  }
+
+  template <typename It, typename End>
+  static std::size_t read_batch(It& it, End const& end, result_t* out,
+                                std::size_t const max_n) {
+    if constexpr (std::is_same_v<It, End> &&
+                  is_random_access_iterator_v<It>) {
+      auto const n = std::min(max_n, static_cast<std::size_t>(end - it));
+      for (auto i = std::size_t{0U}; i != n; ++i) {
+        out[i] = it[static_cast<std::ptrdiff_t>(i)];
+      }
+      it += static_cast<std::ptrdiff_t>(n);
+      return n;
+    } else {
+      auto n = std::size_t{0U};
+      for (; n != max_n && it != end; ++it) {
+        out[n++] = *it;
+      }
+      return n;
+    }
+  }
+
   BeginIt begin_;
   EndIt end_;
 };
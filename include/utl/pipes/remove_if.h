@@ -1,8 +1,14 @@
 #pragma once
 
+#include <cstddef>
+
+#include <type_traits>
 #include <utility>
 
 #include "utl/clear_t.h"
+#include "utl/pipes/batch.h"
+#include "utl/pipes/is_par_range.h"
+#include "utl/pipes/size_hint.h"
 #include "utl/pipes/is_range.h"
 #include "utl/pipes/make_range.h"
 
@@ -12,6 +18,12 @@ template <typename Range, typename RemoveIf>
 struct remove_if_range : public clear_t<Range> {
   using parent_t = clear_t<Range>;
   using result_t = typename parent_t::result_t;
+  using batch_range_t = std::conditional_t<is_batch_range_v<parent_t>,
+                                           remove_if_range, void>;
+  using par_range_t =
+      std::conditional_t<is_chunkable_v<parent_t>, remove_if_range, void>;
+  using size_hint_range_t =
+      std::conditional_t<has_size_hint_v<parent_t>, remove_if_range, void>;
 
   template <typename T>
   remove_if_range(T&& r, RemoveIf&& remove_if)
@@ -37,6 +49,29 @@ struct remove_if_range : public clear_t<Range> {
     return it;
   }
 
+  // Upper bound: the number of removed elements is only known afterwards.
+  std::size_t size_hint() const { return parent_t::size_hint(); }
+
+  // Compacts each parent batch in place. Keeps reading until at least one
+  // element survives, since an empty batch signals the end of the range.
+  template <typename It>
+  std::size_t read_batch(It& it, result_t* out, std::size_t const max_n) {
+    while (true) {
+      auto const n = parent_t::read_batch(it, out, max_n);
+      if (n == 0U) {
+        return 0U;
+      }
+      auto kept = std::size_t{0U};
+      for (auto i = std::size_t{0U}; i != n; ++i) {
+        out[kept] = out[i];
+        kept += remove_if_.fn_(out[i]) ? 0U : 1U;
+      }
+      if (kept != 0U) {
+        return kept;
+      }
+    }
+  }
+
   RemoveIf remove_if_;
 };
 
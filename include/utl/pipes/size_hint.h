@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+
+#include <type_traits>
+#include <utility>
+
+#include "utl/clear_t.h"
+
+namespace utl {
+
+// Optional size protocol: std::size_t size_hint() const returns an upper
+// bound of the number of elements the range yields. Stages whose hint is
+// the exact size (sources, transform) additionally declare
+// exact_size_range_t. remove_if only passes the bound through, so it is
+// never exact.
+//
+// Like the batch protocol (see batch.h), a stage opts in by naming itself
+// in size_hint_range_t / exact_size_range_t, so stages that do not
+// (unique, take_while, ...) lose the hint instead of inheriting a wrong one.
+template <typename Range, typename = void>
+struct has_size_hint : std::false_type {};
+
+template <typename Range>
+struct has_size_hint<Range, std::void_t<typename Range::size_hint_range_t>>
+    : std::is_same<typename Range::size_hint_range_t, Range> {};
+
+template <typename Range>
+constexpr auto const has_size_hint_v = has_size_hint<clear_t<Range>>::value;
+
+template <typename Range, typename = void>
+struct has_exact_size : std::false_type {};
+
+template <typename Range>
+struct has_exact_size<Range, std::void_t<typename Range::exact_size_range_t>>
+    : std::bool_constant<
+          std::is_same_v<typename Range::exact_size_range_t, Range> &&
+          has_size_hint<Range>::value> {};
+
+template <typename Range>
+constexpr auto const has_exact_size_v = has_exact_size<clear_t<Range>>::value;
+
+template <typename Container, typename = void>
+struct has_reserve : std::false_type {};
+
+template <typename Container>
+struct has_reserve<Container, std::void_t<decltype(std::declval<Container&>()
+                                                        .reserve(
+                                                            std::size_t{}))>>
+    : std::true_type {};
+
+// Reserves only for exact sizes: an upper bound may be far off (remove_if)
+// and hashed containers allocate and zero all buckets right away.
+template <typename Container, typename Range>
+void reserve_exact_size(Container& c, Range const& r) {
+  if constexpr (has_exact_size_v<Range> && has_reserve<Container>::value) {
+    c.reserve(r.size_hint());
+  }
+}
+
+}  // namespace utl
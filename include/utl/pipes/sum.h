@@ -1,7 +1,11 @@
 #pragma once
 
+#include <cstddef>
+
 #include <utility>
 
+#include "utl/pipes/batch.h"
+#include "utl/pipes/is_par_range.h"
 #include "utl/pipes/make_range.h"
 
 namespace utl {
@@ -12,12 +16,30 @@ struct sum {
   template <typename T>
   friend auto operator|(T&& t, sum&& f) {
     auto r = make_range(std::forward<T>(t));
-    auto it = r.begin();
-    while (r.valid(it)) {
-      f.acc_ += r.read(it);
-      r.next(it);
+    auto const run = [](auto& range, std::size_t acc) {
+      if constexpr (is_batch_range_v<decltype(range)>) {
+        for_each_batch(range, [&](auto const* batch, std::size_t const n) {
+          for (auto i = std::size_t{0U}; i != n; ++i) {
+            acc += batch[i];
+          }
+        });
+      } else {
+        auto it = range.begin();
+        while (range.valid(it)) {
+          acc += range.read(it);
+          range.next(it);
+        }
+      }
+      return acc;
+    };
+    if constexpr (is_par_range_v<decltype(r)>) {
+      if (r.par_active_) {
+        return par_reduce(
+            r, [&](auto& sub) { return run(sub, std::size_t{0U}); },
+            [](std::size_t& a, std::size_t const b) { a += b; });
+      }
     }
-    return f.acc_;
+    return run(r, f.acc_);
   }
 
   std::size_t acc_ = 0;
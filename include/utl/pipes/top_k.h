@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "utl/clear_t.h"
+#include "utl/pipes/is_par_range.h"
+#include "utl/pipes/make_range.h"
+
+namespace utl {
+
+// The k greatest elements according to cmp (a "less" relation), greatest
+// first. Keeps a bounded heap whose top is the smallest element kept.
+template <typename Cmp>
+struct top_k_t {
+  top_k_t(std::size_t const k, Cmp&& cmp)
+      : k_{k}, cmp_(std::forward<Cmp>(cmp)) {}
+
+  template <typename T>
+  friend auto operator|(T&& t, top_k_t&& f) {
+    auto r = make_range(std::forward<T>(t));
+    using value_t = typename clear_t<decltype(r)>::result_t;
+
+    auto const greater = [&](value_t const& a, value_t const& b) {
+      return f.cmp_(b, a);
+    };
+    auto const add = [&](std::vector<value_t>& heap, auto&& value) {
+      if (heap.size() < f.k_) {
+        heap.emplace_back(std::forward<decltype(value)>(value));
+        std::push_heap(begin(heap), end(heap), greater);
+      } else if (f.k_ != 0U && f.cmp_(heap.front(), value)) {
+        std::pop_heap(begin(heap), end(heap), greater);
+        heap.back() = std::forward<decltype(value)>(value);
+        std::push_heap(begin(heap), end(heap), greater);
+      }
+    };
+    auto const run = [&](auto& range) {
+      auto heap = std::vector<value_t>{};
+      heap.reserve(f.k_);
+      auto it = range.begin();
+      while (range.valid(it)) {
+        add(heap, range.read(it));
+        range.next(it);
+      }
+      return heap;
+    };
+
+    auto heap = std::vector<value_t>{};
+    if constexpr (is_par_range_v<decltype(r)>) {
+      if (r.par_active_) {
+        heap = par_reduce(r, run,
+                          [&](std::vector<value_t>& a,
+                              std::vector<value_t>&& b) {
+                            for (auto& value : b) {
+                              add(a, std::move(value));
+                            }
+                          });
+      } else {
+        heap = run(r);
+      }
+    } else {
+      heap = run(r);
+    }
+    std::sort_heap(begin(heap), end(heap), greater);
+    return heap;
+  }
+
+  std::size_t k_;
+  Cmp cmp_;
+};
+
+template <typename Cmp = std::less<>>
+top_k_t<Cmp> top_k(std::size_t const k, Cmp&& cmp = Cmp{}) {
+  return top_k_t<Cmp>(k, std::forward<Cmp>(cmp));
+}
+
+}  // namespace utl
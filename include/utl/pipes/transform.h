@@ -1,8 +1,16 @@
 #pragma once
 
+#include <cstddef>
+
+#include <algorithm>
+#include <array>
+#include <type_traits>
 #include <utility>
 
 #include "utl/clear_t.h"
+#include "utl/pipes/batch.h"
+#include "utl/pipes/is_par_range.h"
+#include "utl/pipes/size_hint.h"
 #include "utl/pipes/make_range.h"
 
 namespace utl {
@@ -12,6 +20,14 @@ struct transform_range : public clear_t<Range> {
   using parent_t = clear_t<Range>;
   using result_t = clear_t<decltype(std::declval<Transform>().fn_(
       std::declval<typename parent_t::result_t>()))>;
+  using batch_range_t = std::conditional_t<is_batch_range_v<parent_t>,
+                                           transform_range, void>;
+  using par_range_t =
+      std::conditional_t<is_chunkable_v<parent_t>, transform_range, void>;
+  using size_hint_range_t =
+      std::conditional_t<has_size_hint_v<parent_t>, transform_range, void>;
+  using exact_size_range_t =
+      std::conditional_t<has_exact_size_v<parent_t>, transform_range, void>;
 
   template <typename T>
   transform_range(T&& r, Transform&& transform)
@@ -23,6 +39,28 @@ struct transform_range : public clear_t<Range> {
     return transform_.fn_(parent_t::read(it));
   }
 
+  std::size_t size_hint() const { return parent_t::size_hint(); }
+
+  template <typename It>
+  std::size_t read_batch(It& it, result_t* out, std::size_t max_n) {
+    using in_t = typename parent_t::result_t;
+    if constexpr (std::is_same_v<in_t, result_t>) {
+      auto const n = parent_t::read_batch(it, out, max_n);
+      for (auto i = std::size_t{0U}; i != n; ++i) {
+        out[i] = transform_.fn_(out[i]);
+      }
+      return n;
+    } else {
+      std::array<in_t, pipe_batch_size_v<in_t>> in;
+      auto const n = parent_t::read_batch(it, in.data(),
+                                          std::min(max_n, in.size()));
+      for (auto i = std::size_t{0U}; i != n; ++i) {
+        out[i] = transform_.fn_(in[i]);
+      }
+      return n;
+    }
+  }
+
   Transform transform_;
 };
 
@@ -1,22 +1,53 @@
 #pragma once
 
+#include <iterator>
+#include <utility>
 #include <vector>
 
 #include "utl/clear_t.h"
+#include "utl/pipes/is_par_range.h"
 #include "utl/pipes/make_range.h"
+#include "utl/pipes/size_hint.h"
 
 namespace utl {
 
+namespace detail {
+
+// Combines the chunk results of a parallel pipeline in chunk order.
+template <bool Append, typename Range, typename Run>
+auto par_collect(Range const& r, Run&& run) {
+  using container_t = clear_t<decltype(run(std::declval<clear_t<Range>&>()))>;
+  return par_reduce(r, run, [](container_t& a, container_t&& b) {
+    if constexpr (Append) {
+      a.insert(end(a), std::make_move_iterator(begin(b)),
+               std::make_move_iterator(end(b)));
+    } else {
+      a.insert(begin(b), end(b));
+    }
+  });
+}
+
+}  // namespace detail
+
 struct to_vec_t {
   template <typename T>
   friend auto operator|(T&& r, to_vec_t&&) {
-    auto it = r.begin();
-    std::vector<clear_t<decltype(r.read(it))>> v;
-    while (r.valid(it)) {
-      v.emplace_back(r.read(it));
-      r.next(it);
+    auto const run = [](auto& range) {
+      auto it = range.begin();
+      std::vector<clear_t<decltype(range.read(it))>> v;
+      reserve_exact_size(v, range);
+      while (range.valid(it)) {
+        v.emplace_back(range.read(it));
+        range.next(it);
+      }
+      return v;
+    };
+    if constexpr (is_par_range_v<T>) {
+      if (r.par_active_) {
+        return detail::par_collect<true>(r, run);
+      }
     }
-    return v;
+    return run(r);
   }
 };
 
@@ -26,13 +57,22 @@ template <typename Container>
 struct emplace_to_t {
   template <typename T>
   friend auto operator|(T&& r, emplace_to_t&&) {
-    auto it = r.begin();
-    Container c;
-    while (r.valid(it)) {
-      c.emplace(r.read(it));
-      r.next(it);
+    auto const run = [](auto& range) {
+      auto it = range.begin();
+      Container c;
+      reserve_exact_size(c, range);
+      while (range.valid(it)) {
+        c.emplace(range.read(it));
+        range.next(it);
+      }
+      return c;
+    };
+    if constexpr (is_par_range_v<T>) {
+      if (r.par_active_) {
+        return detail::par_collect<false>(r, run);
+      }
     }
-    return c;
+    return run(r);
   }
 };
 
@@ -45,13 +85,22 @@ template <typename Container>
 struct emplace_back_to_t {
   template <typename T>
   friend auto operator|(T&& r, emplace_back_to_t&&) {
-    auto it = r.begin();
-    Container c;
-    while (r.valid(it)) {
-      c.emplace_back(r.read(it));
-      r.next(it);
+    auto const run = [](auto& range) {
+      auto it = range.begin();
+      Container c;
+      reserve_exact_size(c, range);
+      while (range.valid(it)) {
+        c.emplace_back(range.read(it));
+        range.next(it);
+      }
+      return c;
+    };
+    if constexpr (is_par_range_v<T>) {
+      if (r.par_active_) {
+        return detail::par_collect<true>(r, run);
+      }
     }
-    return c;
+    return run(r);
   }
 };
 
@@ -68,6 +68,8 @@ struct thread_pool {
   thread_pool(thread_pool&&) noexcept = delete;  // NOLINT
   thread_pool& operator=(thread_pool&&) noexcept = delete;  // NOLINT
 
+  size_t size() const { return threads_.size(); }
+
   void execute(size_t const job_count, std::function<void(size_t)>&& fn) {
     if (job_count == 0) {
       return;
@@ -1,4 +1,11 @@
+#include <clocale>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
 
 #include "catch2/catch_all.hpp"
 
@@ -237,3 +244,203 @@ TEST_CASE("parse_int_substr") {
   sub >> a;
   REQUIRE(a == 34);
 }
+
+TEST_CASE("parse_double_exact") {
+  auto const check = [](char const* str) {
+    cstr s = str;
+    double d{};
+    CHECK(parse_arg(s, d));
+    CHECK(s.len == 0);
+    CHECK(d == std::strtod(str, nullptr));
+  };
+
+  check("0");
+  check("-0.0");
+  check("1");
+  check("13.4050812");
+  check("52.520008");
+  check("0.1");
+  check("0.30000000000000004");
+  check("1e-5");
+  check("+2.5E+10");
+  check("123456789012345678901234567890");
+  check("9007199254740993");
+  check("2.2250738585072011e-308");
+  check("4.9406564584124654e-324");
+  check("1.7976931348623157e308");
+  check("3.14159265358979323846264338327950288419716939937510");
+  check("0.000000000000000000000000000000000000000000001");
+  check(".5");
+  check("5.");
+  check("1e400");
+  check("1e-400");
+}
+
+TEST_CASE("parse_double_random") {
+  auto gen = std::mt19937_64{7U};
+  char buf[64];
+  for (auto i = 0U; i != 10000U; ++i) {
+    auto const bits = gen();
+    double x;
+    std::memcpy(&x, &bits, sizeof(x));
+    if (!std::isfinite(x)) {
+      continue;
+    }
+    std::snprintf(buf, sizeof(buf), (i % 2U == 0U) ? "%.17g" : "%.9g", x);
+    cstr s = buf;
+    double d{};
+    REQUIRE(parse_arg(s, d));
+    REQUIRE(d == std::strtod(buf, nullptr));
+  }
+}
+
+TEST_CASE("parse_float_exact") {
+  for (auto const str : {"33.7994", "1.17549435e-38", "3.4028235e38",
+                         "0.1", "16777217", "1e-46", "7.038531e-26"}) {
+    cstr s = str;
+    float f{};
+    CHECK(parse_arg(s, f));
+    CHECK(f == std::strtof(str, nullptr));
+  }
+}
+
+TEST_CASE("parse_double_slow_path_ignores_locale") {
+  // Halfway cases with more than 19 significant digits go through strtod.
+  auto const str = "9007199254740993.00000000000000000001";
+  auto const str_f = "16777217.00000000000000000001";
+  auto const expected = std::strtod(str, nullptr);
+  auto const expected_f = std::strtof(str_f, nullptr);
+
+  auto const prev = std::string{std::setlocale(LC_NUMERIC, nullptr)};
+  auto found = false;
+  for (auto const name : {"de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8",
+                          "fr_FR.utf8", "fr_FR", "German_Germany.1252"}) {
+    if (std::setlocale(LC_NUMERIC, name) != nullptr &&
+        *std::localeconv()->decimal_point == ',') {
+      found = true;
+      break;
+    }
+  }
+  if (!found) {
+    std::setlocale(LC_NUMERIC, prev.c_str());
+    WARN("no locale with a decimal comma installed");
+    return;
+  }
+
+  cstr s = str;
+  double d{};
+  auto const ok = parse_arg(s, d);
+
+  cstr sf = str_f;
+  float f{};
+  auto const ok_f = parse_arg(sf, f);
+
+  std::setlocale(LC_NUMERIC, prev.c_str());
+
+  CHECK(ok);
+  CHECK(d == expected);
+  CHECK(ok_f);
+  CHECK(f == expected_f);
+}
+
+TEST_CASE("parse_double_special") {
+  double d{};
+
+  cstr s = "inf";
+  CHECK(parse_arg(s, d));
+  CHECK(std::isinf(d));
+  CHECK(d > 0);
+
+  s = "-Infinity";
+  CHECK(parse_arg(s, d));
+  CHECK(std::isinf(d));
+  CHECK(d < 0);
+
+  s = "NaN";
+  CHECK(parse_arg(s, d));
+  CHECK(std::isnan(d));
+
+  s = "1e;";
+  CHECK(!parse_arg(s, d));
+  CHECK(d == 1.0);
+  CHECK(s.len == 2);
+
+  s = "abc";
+  CHECK(!parse_arg(s, d));
+  CHECK(d == 0.0);
+}
+
+TEST_CASE("parse_int_long_runs") {
+  for (auto const str : {"1", "12345678", "123456789", "1234567890123456",
+                         "12345678901234567", "000000000000042"}) {
+    cstr s = str;
+    std::int64_t i{};
+    CHECK(parse_arg(s, i));
+    CHECK(s.len == 0);
+    CHECK(i == std::strtoll(str, nullptr, 10));
+  }
+
+  cstr s = "-9223372036854775808,";
+  std::int64_t i{};
+  CHECK(!parse_arg(s, i));
+  CHECK(i == std::numeric_limits<std::int64_t>::min());
+  CHECK(s.len == 1);
+  CHECK(*s.str == ',');
+
+  s = "4294967295";
+  std::uint32_t u{};
+  CHECK(parse_arg(s, u));
+  CHECK(u == std::numeric_limits<std::uint32_t>::max());
+}
+
+TEST_CASE("parse_int_checked") {
+  std::int32_t i{};
+
+  cstr s = "2147483647";
+  CHECK(parse_arg_checked(s, i));
+  CHECK(i == 2147483647);
+
+  s = "-2147483648";
+  CHECK(parse_arg_checked(s, i));
+  CHECK(i == std::numeric_limits<std::int32_t>::min());
+
+  s = "2147483648";
+  CHECK(!parse_arg_checked(s, i));
+  CHECK(i == std::numeric_limits<std::int32_t>::max());
+
+  s = "-99999999999999999999999";
+  CHECK(!parse_arg_checked(s, i));
+  CHECK(i == std::numeric_limits<std::int32_t>::min());
+
+  std::uint64_t u{};
+  s = "18446744073709551615";
+  CHECK(parse_arg_checked(s, u));
+  CHECK(u == std::numeric_limits<std::uint64_t>::max());
+
+  s = "18446744073709551616";
+  CHECK(!parse_arg_checked(s, u));
+}
+
+TEST_CASE("parse_fixed_width") {
+  cstr s = "20240131,235959";
+  int date{}, time{};
+  REQUIRE(parse_fixed<8>(s, date));
+  CHECK(date == 20240131);
+  CHECK(*s.str == ',');
+  ++s;
+  REQUIRE(parse_fixed<6>(s, time));
+  CHECK(time == 235959);
+  CHECK(s.len == 0);
+
+  cstr t = "12a456";
+  CHECK(!parse_fixed<6>(t, time));
+  CHECK(t.len == 6);
+
+  cstr u = "12345";
+  CHECK(!parse_fixed<6>(u, time));
+
+  cstr v = "1234567890123456";
+  std::uint64_t x{};
+  REQUIRE(parse_fixed<16>(v, x));
+  CHECK(x == 1234567890123456ULL);
+}
@@ -0,0 +1,141 @@
+#include "catch2/catch_all.hpp"
+
+#include <cstdio>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "utl/parser/async_reader.h"
+#include "utl/parser/csv_range.h"
+#include "utl/parser/line_range.h"
+#include "utl/pipes/vec.h"
+
+using namespace utl;
+
+namespace {
+
+struct tmp_file {
+  explicit tmp_file(std::string const& content)
+      : path_{(std::filesystem::temp_directory_path() /
+               ("utl_async_reader_test_" + std::to_string(content.size())))
+                  .string()} {
+    auto const f = std::fopen(path_.c_str(), "wb");
+    REQUIRE(f != nullptr);
+    REQUIRE(std::fwrite(content.data(), 1U, content.size(), f) ==
+            content.size());
+    std::fclose(f);
+  }
+
+  ~tmp_file() { std::filesystem::remove(path_); }
+
+  std::string path_;
+};
+
+}  // namespace
+
+TEST_CASE("async_reader") {
+  auto input = std::string{};
+  auto expected_lines = std::vector<std::string>{};
+  for (auto i = 0U; i != 500U; ++i) {
+    expected_lines.emplace_back(std::string(i % 37U, 'a' + (i % 26U)));
+    input += expected_lines.back() + "\n";
+  }
+  input += "last";
+  expected_lines.emplace_back("last");
+
+  auto const f = tmp_file{input};
+  for (auto const b : {async_reader::backend::kAuto,
+                       async_reader::backend::kPreadThread}) {
+    for (auto const block_size : {1U, 5U, 64U, 100000U}) {
+      for (auto const depth : {1U, 3U}) {
+        auto blocks = std::string{};
+        auto r = async_reader{f.path_.c_str(), block_size, depth, b};
+        for (auto block = r.next_block(); block.len != 0U;
+             block = r.next_block()) {
+          blocks.append(block.str, block.len);
+        }
+        CHECK(blocks == input);
+
+        auto lines = std::vector<std::string>{};
+        auto lr = async_reader{f.path_.c_str(), block_size, depth, b};
+        for (auto line = lr.read_line(); line.str != nullptr;
+             line = lr.read_line()) {
+          lines.emplace_back(line.view());
+        }
+        CHECK(lines == expected_lines);
+      }
+    }
+  }
+}
+
+TEST_CASE("async_reader csv") {
+  struct row {
+    csv_col<int, UTL_NAME("a")> a_;
+    csv_col<std::string, UTL_NAME("b")> b_;
+  };
+
+  auto input = std::string{"b,a\n"};
+  for (auto i = 0; i != 1000; ++i) {
+    input += "text" + std::to_string(i) + "," + std::to_string(i) + "\n";
+  }
+
+  auto const f = tmp_file{input};
+  auto const rows =
+      line_range{async_reader{f.path_.c_str(), 128U}} | csv<row>() | vec();
+  REQUIRE(rows.size() == 1000U);
+  CHECK(rows[999].a_.val() == 999);
+  CHECK(rows[999].b_.val() == "text999");
+}
+
+TEST_CASE("async_reader failed read only affects its slot") {
+  auto const input = std::string(1000U, 'x');
+  auto const f = tmp_file{input};
+  auto const file = mmap_reader::file{f.path_.c_str()};
+
+  auto backends = std::vector<std::unique_ptr<detail::async_read_backend>>{};
+  backends.emplace_back(
+      std::make_unique<detail::pread_thread_backend>(file.fd_, 3U));
+#ifdef UTL_IO_URING
+  if (auto uring = std::make_unique<detail::io_uring_backend>(file.fd_, 3U);
+      uring->valid()) {
+    backends.emplace_back(std::move(uring));
+  }
+#endif
+
+  for (auto& b : backends) {
+    auto buf = std::vector<char>(200U);
+    b->submit(0U, nullptr, 100U, 0U);  // EFAULT
+    b->submit(1U, buf.data(), 100U, 100U);
+    b->submit(2U, buf.data() + 100U, 100U, 900U);
+    CHECK(b->wait(1U) == 100U);
+    CHECK(b->wait(2U) == 100U);
+    CHECK_THROWS(b->wait(0U));
+    CHECK(std::string(buf.data(), buf.size()) == std::string(200U, 'x'));
+
+    b->submit(0U, buf.data(), 100U, 0U);
+    CHECK(b->wait(0U) == 100U);
+  }
+}
+
+TEST_CASE("async_reader read error") {
+  auto const dir =
+      std::filesystem::temp_directory_path() / "utl_async_reader_test_dir";
+  std::filesystem::create_directories(dir);
+  for (auto i = 0U; i != 8U; ++i) {
+    std::fclose(std::fopen((dir / std::to_string(i)).string().c_str(), "wb"));
+  }
+
+  if (mmap_reader::file{dir.string().c_str()}.size_ >= 3U) {
+    for (auto const b : {async_reader::backend::kAuto,
+                         async_reader::backend::kPreadThread}) {
+      // Reading a directory fails (EISDIR) for every slot in flight.
+      auto r = async_reader{dir.string().c_str(), 1U, 3U, b};
+      CHECK_THROWS(r.next_block());
+      CHECK_THROWS(r.next_block());
+    }
+  }
+
+  std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,88 @@
+#include "catch2/catch_all.hpp"
+
+#include <cstdint>
+
+#include <thread>
+#include <vector>
+
+#include "utl/parser/buffer.h"
+
+using namespace utl;
+
+namespace {
+
+bool is_padded(buffer const& b) {
+  for (auto i = 0U; i != kBufferPadding; ++i) {
+    if (b.data()[b.size() + i] != 0U) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST_CASE("buffer alignment and padding") {
+  auto b = buffer{"hello world"};
+  CHECK(reinterpret_cast<std::uintptr_t>(b.data()) % kBufferAlignment == 0U);
+  CHECK(b.size() == 11U);
+  CHECK(is_padded(b));
+
+  std::memset(b.data(), 'x', b.size());
+  b.resize(5U);
+  CHECK(is_padded(b));
+
+  b.resize(1000U);
+  CHECK(reinterpret_cast<std::uintptr_t>(b.data()) % kBufferAlignment == 0U);
+  CHECK(std::memcmp(b.data(), "xxxxx", 5U) == 0);
+  CHECK(is_padded(b));
+
+  auto moved = std::move(b);
+  CHECK(moved.size() == 1000U);
+  CHECK(b.data() == nullptr);
+}
+
+TEST_CASE("buffer pool reuse") {
+  auto pool = buffer_pool{2U};
+
+  void* first = nullptr;
+  {
+    auto b = pool.get(10000U);
+    first = b.data();
+    CHECK(is_padded(b));
+  }
+  CHECK(pool.cached() == 1U);
+
+  {
+    auto b = pool.get(9000U);
+    CHECK(b.data() == first);
+    CHECK(b.size() == 9000U);
+    CHECK(is_padded(b));
+    CHECK(pool.cached() == 0U);
+
+    auto small = pool.get(100U);
+    CHECK(small.data() != first);
+  }
+  CHECK(pool.cached() == 2U);
+
+  {
+    auto b = pool.get(100000U);
+    CHECK(pool.cached() == 2U);
+  }
+  CHECK(pool.cached() == 2U);
+
+  auto threads = std::vector<std::thread>{};
+  for (auto t = 0U; t != 4U; ++t) {
+    threads.emplace_back([&, t]() {
+      for (auto i = 0U; i != 1000U; ++i) {
+        auto b = pool.get(1000U + (i * 7U + t) % 3000U);
+        std::memset(b.data(), static_cast<int>(t), b.size());
+        CHECK(is_padded(b));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  CHECK(pool.cached() <= 2U);
+}
@@ -1,5 +1,8 @@
 #include "catch2/catch_all.hpp"
 
+#include <limits>
+#include <string>
+
 #include "utl/parser/cstr.h"
 
 namespace utl::cstr_test {
@@ -134,4 +137,81 @@ TEST_CASE("sbustr_pos_middle") {
   REQUIRE(s.substr(1, 2).str == s.str + 1);
 }
 
+TEST_CASE("trim") {
+  CHECK(cstr{" \t\r\n abc \t\r\n"}.trim() == "abc");
+  CHECK(cstr{" \t "}.trim().len == 0U);
+  CHECK(cstr{""}.trim().len == 0U);
+  CHECK(cstr{}.trim().len == 0U);
+
+  for (auto pad = 0U; pad != 40U; ++pad) {
+    auto const spaces = std::string(pad, pad % 2U == 0U ? ' ' : '\t');
+    auto const s = spaces + "a b" + spaces;
+    CHECK(cstr{s}.skip_whitespace_front() == std::string{"a b"} + spaces);
+    CHECK(cstr{s}.skip_whitespace_back() == spaces + "a b");
+    CHECK(cstr{s}.trim() == "a b");
+  }
+}
+
+TEST_CASE("substr_offset") {
+  auto const text = std::string(100U, 'a') + "abcab" + std::string(3U, 'b');
+  auto const s = cstr{text};
+  CHECK(s.substr_offset("abcab") == 100U);
+  CHECK(s.substr_offset("b") == 101U);
+  CHECK(s.substr_offset("bbb") == 104U);
+  CHECK(s.substr_offset("abcb") == std::numeric_limits<size_t>::max());
+  CHECK(s.substr_offset("") == 0U);
+  CHECK(cstr{""}.substr_offset("") == std::numeric_limits<size_t>::max());
+  CHECK(s.contains("cab"));
+  CHECK(!s.contains("ba"));
+  CHECK(cstr{"ab"}.substr_offset("abc") ==
+        std::numeric_limits<size_t>::max());
+
+  for (auto pos = 0U; pos != 40U; ++pos) {
+    auto haystack = std::string(40U, 'x');
+    haystack.replace(pos, 3U, "xyz");
+    CHECK(cstr{haystack}.substr_offset("xyz") == pos);
+  }
+}
+
+TEST_CASE("substr_offset many false candidates") {
+  // Every position passes the first/last byte filter: switches to Two-Way.
+  auto const needle = std::string(998U, 'a') + "ba";
+  auto text = std::string(200000U, 'a');
+  CHECK(cstr{text}.substr_offset(cstr{needle}) ==
+        std::numeric_limits<size_t>::max());
+  text.replace(150000U, needle.size(), needle);
+  CHECK(cstr{text}.substr_offset(cstr{needle}) == 150000U);
+
+  // Periodic needle.
+  auto const periodic = std::string{"abaabaabaabaabaabab"};
+  auto haystack = std::string{};
+  for (auto i = 0U; i != 5000U; ++i) {
+    haystack += "abaab";
+  }
+  CHECK(cstr{haystack}.substr_offset(cstr{periodic}) ==
+        std::numeric_limits<size_t>::max());
+  haystack += "abaabaabaabaabaabab";
+  CHECK(cstr{haystack}.substr_offset(cstr{periodic}) ==
+        haystack.find(periodic));
+}
+
+TEST_CASE("equals_ignore_case") {
+  CHECK(cstr{"Stop_Name"}.equals_ignore_case("stop_name"));
+  CHECK(cstr{"ABCDEFGHIJKLMNOPQRSTUVWXYZ[@"}.equals_ignore_case(
+      "abcdefghijklmnopqrstuvwxyz[@"));
+  CHECK(!cstr{"ABCDEFGHIJKLMNOPQRSTUVWXYZ@"}.equals_ignore_case(
+      "abcdefghijklmnopqrstuvwxyz`"));
+  CHECK(!cstr{"stop_name"}.equals_ignore_case("stop_nam"));
+  CHECK(!cstr{"[\\]^_"}.equals_ignore_case("{|}~\x7F"));
+  CHECK(cstr{""}.equals_ignore_case(""));
+}
+
+TEST_CASE("starts_with_ends_with") {
+  CHECK(cstr{"abc"}.starts_with("ab"));
+  CHECK(cstr{"abc"}.starts_with(""));
+  CHECK(!cstr{"abc"}.starts_with("abcd"));
+  CHECK(cstr{"abc"}.ends_with("bc"));
+  CHECK(!cstr{"abc"}.ends_with("ab"));
+}
+
 }  // namespace utl::cstr_test
@@ -0,0 +1,98 @@
+#include "catch2/catch_all.hpp"
+
+#include <string>
+#include <vector>
+
+#include "utl/parser/buf_reader.h"
+#include "utl/parser/csv_range.h"
+#include "utl/parser/csv_writer.h"
+#include "utl/parser/line_range.h"
+#include "utl/pipes/all.h"
+#include "utl/pipes/vec.h"
+
+using namespace utl;
+
+namespace {
+
+struct string_sink {
+  void write(char const* data, std::size_t const n) {
+    s_.append(data, n);
+    ++writes_;
+  }
+
+  std::string s_;
+  unsigned writes_{0U};
+};
+
+struct entry {
+  csv_col<int, UTL_NAME("id")> id_;
+  csv_col<double, UTL_NAME("value")> value_;
+  csv_col<std::string, UTL_NAME("name")> name_;
+  csv_col<bool, UTL_NAME("active")> active_;
+  csv_col<cstr, UTL_NAME("tag")> tag_;
+};
+
+}  // namespace
+
+TEST_CASE("write_csv") {
+  auto const rows = std::vector<entry>{
+      {-1, 0.1, std::string{"plain"}, true, cstr{"a"}},
+      {42, 1e300, std::string{"with,comma"}, false, cstr{"say \"hi\""}},
+      {7, -2.5, std::string{"multi\nline"}, true, cstr{""}}};
+
+  auto sink = string_sink{};
+  CHECK((all(rows) | write_csv<entry>(sink)) == 3U);
+  CHECK(sink.s_ ==
+        "id,value,name,active,tag\n"
+        "-1,0.1,plain,true,a\n"
+        "42,1e+300,\"with,comma\",false,\"say \"\"hi\"\"\"\n"
+        "7,-2.5,\"multi\nline\",true,\n");
+  CHECK(sink.writes_ == 1U);
+}
+
+TEST_CASE("write_csv round trip") {
+  auto rows = std::vector<entry>{};
+  for (auto i = 0; i != 1000; ++i) {
+    rows.push_back({i, i / 7.0, "name" + std::to_string(i), i % 2 == 0,
+                    cstr{"x;y"}});
+  }
+
+  auto sink = string_sink{};
+  all(rows) | write_csv<entry, ';'>(sink, 256U);
+  CHECK(sink.writes_ > 1U);
+
+  auto const parsed = line_range{buf_reader{sink.s_}}  //
+                      | csv<entry, ';', simd>()  //
+                      | vec();
+  REQUIRE(parsed.size() == rows.size());
+  for (auto i = 0U; i != rows.size(); ++i) {
+    CHECK(parsed[i].id_.val() == rows[i].id_.val());
+    CHECK(parsed[i].value_.val() == rows[i].value_.val());
+    CHECK(parsed[i].name_.val() == rows[i].name_.val());
+    CHECK(parsed[i].active_.val() == rows[i].active_.val());
+    CHECK(parsed[i].tag_.val() == "x;y");
+  }
+}
+
+TEST_CASE("write_csv round trip quotes") {
+  auto const names = std::vector<std::string>{
+      "say \"hi\"", "\"", "\"\"", "a,\"b\",c", "\"quoted\""};
+  auto rows = std::vector<entry>{};
+  for (auto const& name : names) {
+    rows.push_back({1, 2.0, name, true, cstr{"x"}});
+  }
+
+  auto sink = string_sink{};
+  all(rows) | write_csv<entry>(sink);
+
+  auto const scalar_parsed =
+      line_range{buf_reader{sink.s_}} | csv<entry>() | vec();
+  auto const simd_parsed =
+      line_range{buf_reader{sink.s_}} | csv<entry, ',', simd>() | vec();
+  REQUIRE(scalar_parsed.size() == names.size());
+  REQUIRE(simd_parsed.size() == names.size());
+  for (auto i = 0U; i != names.size(); ++i) {
+    CHECK(unescape_csv(scalar_parsed[i].name_.val()) == names[i]);
+    CHECK(unescape_csv(simd_parsed[i].name_.val()) == names[i]);
+  }
+}
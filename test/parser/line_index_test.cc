@@ -0,0 +1,263 @@
+#include "catch2/catch_all.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+#include <chrono>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "utl/parser/buf_reader.h"
+#include "utl/parser/line_index.h"
+
+using namespace utl;
+
+namespace {
+
+std::vector<std::string> read_lines(cstr const s) {
+  auto lines = std::vector<std::string>{};
+  auto r = buf_reader{s};
+  for (auto line = r.read_line(); line.str != nullptr; line = r.read_line()) {
+    lines.emplace_back(line.view());
+  }
+  return lines;
+}
+
+}  // namespace
+
+TEST_CASE("line_index build") {
+  thread_pool pool;
+
+  auto text = std::string{};
+  for (auto i = 0U; i != 2000U; ++i) {
+    text += std::string(i % 150U, static_cast<char>('a' + (i % 26U))) +
+            (i % 3U == 0U ? "\r\n" : "\n");
+  }
+
+  for (auto const& s : {std::string{}, std::string{"\n"}, std::string{"x"},
+                        std::string{"a\n\nb"}, text, text + "tail"}) {
+    auto const expected = read_lines(s);
+    for (auto const chunk_size : {1U, 7U, 64U, 1000U, 1U << 20U}) {
+      auto const idx = line_index::build(pool, s, chunk_size);
+      REQUIRE(idx.size() == expected.size());
+      for (auto i = 0U; i != expected.size(); ++i) {
+        CHECK(idx.line(s, i).view() == expected[i]);
+      }
+    }
+  }
+}
+
+TEST_CASE("line_index persist and split") {
+  thread_pool pool;
+  auto text = std::string{};
+  for (auto i = 0U; i != 10000U; ++i) {
+    text += std::to_string(i) + "\n";
+  }
+
+  auto const path =
+      (std::filesystem::temp_directory_path() / "utl_line_index_test.idx")
+          .string();
+  std::filesystem::remove(path);
+
+  auto const hash = line_index::sampled_hash(text);
+  CHECK(!line_index::load(path.c_str(), text.size(), hash).has_value());
+  {
+    auto const idx = line_index::load_or_build(pool, text, path.c_str(),
+                                               line_index_check::kSampled);
+    CHECK(idx.map_ == std::nullopt);
+    CHECK(idx.size() == 10000U);
+  }
+
+  auto const loaded = line_index::load(path.c_str(), text.size(), hash);
+  REQUIRE(loaded.has_value());
+  CHECK(loaded->map_.has_value());
+  REQUIRE(loaded->size() == 10000U);
+  CHECK(loaded->line(text, 0U).view() == "0");
+  CHECK(loaded->line(text, 9999U).view() == "9999");
+  CHECK(loaded->line(text, 1234U).view() == "1234");
+
+  CHECK(!line_index::load(path.c_str(), text.size() + 1U, hash).has_value());
+
+  // Same size, different content.
+  auto edited = text;
+  edited[10] = 'x';
+  CHECK(line_index::sampled_hash(edited) != hash);
+  CHECK(!line_index::load(path.c_str(), text.size(),
+                          line_index::sampled_hash(edited))
+             .has_value());
+
+  // Small texts are hashed completely by both checks.
+  auto const full = line_index::content_hash(pool, text);
+  CHECK(full == hash);
+  CHECK(line_index::load_or_build(pool, text, path.c_str(),
+                                  line_index_check::kFull)
+            .map_.has_value());
+  CHECK(line_index::content_hash(pool, edited) != full);
+
+  auto const parts = loaded->split(3U);
+  REQUIRE(parts.size() == 3U);
+  auto joined = std::string{};
+  for (auto const& [from, to] : parts) {
+    joined += loaded->lines(text, from, to).view();
+  }
+  CHECK(joined == text);
+  CHECK(parts[0].first == 0U);
+  CHECK(parts[2].second == 10000U);
+
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("line_index sampled hash") {
+  // Larger than the sampled part: only edits in the prefix, the suffix or a
+  // sampled block change the hash.
+  auto const text = std::string(8U * 1024U * 1024U, 'a');
+  auto const hash = line_index::sampled_hash(text);
+  CHECK(line_index::sampled_hash(text) == hash);
+
+  auto const edge = std::size_t{1024U * 1024U};
+  for (auto const pos : {std::size_t{0U}, edge - 1U, edge,
+                         text.size() - edge - 1U, text.size() - 1U}) {
+    auto edited = text;
+    edited[pos] = 'b';
+    CHECK(line_index::sampled_hash(edited) != hash);
+  }
+  CHECK(line_index::sampled_hash(text + "a") != hash);
+
+  thread_pool pool;
+  auto edited = text;
+  edited[text.size() / 2U] = 'b';  // between two sampled blocks
+  CHECK(line_index::sampled_hash(edited) == hash);
+  CHECK(line_index::content_hash(pool, edited) !=
+        line_index::content_hash(pool, text));
+}
+
+TEST_CASE("line_index load_or_build rebuilds after in-place edit") {
+  thread_pool pool;
+  auto text = std::string{};
+  while (text.size() < 8U * 1024U * 1024U) {
+    text += "line " + std::to_string(text.size()) + "\n";
+  }
+
+  auto const path =
+      (std::filesystem::temp_directory_path() / "utl_line_index_edit.idx")
+          .string();
+  std::filesystem::remove(path);
+  CHECK(line_index::load_or_build(pool, text, path.c_str()).size() ==
+        read_lines(text).size());
+
+  // Same size, one line moved by a byte between two sampled blocks.
+  auto edited = text;
+  auto const pos = edited.find('\n', edited.size() / 2U);
+  REQUIRE(pos != std::string::npos);
+  std::swap(edited[pos - 1U], edited[pos]);
+  REQUIRE(line_index::sampled_hash(edited) == line_index::sampled_hash(text));
+
+  auto const idx = line_index::load_or_build(pool, edited, path.c_str());
+  CHECK(idx.map_ == std::nullopt);
+  auto const expected = read_lines(edited);
+  REQUIRE(idx.size() == expected.size());
+  for (auto i = 0U; i != expected.size(); ++i) {
+    REQUIRE(idx.line(edited, i).view() == expected[i]);
+  }
+
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("line_index load_or_build with file stat") {
+  thread_pool pool;
+  auto const dir = std::filesystem::temp_directory_path();
+  auto const text_path = (dir / "utl_line_index_stat.txt").string();
+  auto const index_path = (dir / "utl_line_index_stat.idx").string();
+  std::filesystem::remove(index_path);
+
+  auto const write_text = [&](std::string const& content) {
+    auto f = file{text_path.c_str(), "w+"};
+    f.write(content.data(), content.size());
+  };
+  auto const load = [&](line_index_check const check) {
+    auto const m = mmap_reader::memory_map{text_path.c_str()};
+    auto const data = cstr{m.ptr(), m.size()};
+    auto idx = line_index::load_or_build(pool, data, text_path.c_str(),
+                                         index_path.c_str(), check);
+    auto const expected = read_lines(data);
+    REQUIRE(idx.size() == expected.size());
+    for (auto i = 0U; i != expected.size(); ++i) {
+      CHECK(idx.line(data, i).view() == expected[i]);
+    }
+    return idx.map_.has_value();
+  };
+
+  auto text = std::string{};
+  for (auto i = 0U; i != 1000U; ++i) {
+    text += std::to_string(i) + "\n";
+  }
+  write_text(text);
+  CHECK(!load(line_index_check::kFileStat));  // built
+  CHECK(load(line_index_check::kFileStat));  // loaded by file stat
+
+  // Loading by file stat does not read the text.
+  {
+    auto const other = std::string(text.size(), '\n');
+    auto const idx = line_index::load_or_build(
+        pool, other, text_path.c_str(), index_path.c_str());
+    CHECK(idx.map_.has_value());
+    CHECK(idx.size() == 1000U);
+  }
+
+  // Touched, same content: hash matches, index is written again.
+  auto const t = std::filesystem::last_write_time(text_path);
+  std::filesystem::last_write_time(text_path, t + std::chrono::hours{1});
+  CHECK(!load(line_index_check::kFileStat));
+  CHECK(load(line_index_check::kFileStat));
+
+  // Edited in place with the same size: rebuilt.
+  auto edited = text;
+  std::swap(edited[500U], edited[501U]);
+  REQUIRE(edited != text);
+  write_text(edited);
+  std::filesystem::last_write_time(text_path, t + std::chrono::hours{2});
+  CHECK(!load(line_index_check::kFileStat));
+  CHECK(load(line_index_check::kFull));
+
+  std::filesystem::remove(text_path);
+  std::filesystem::remove(index_path);
+}
+
+TEST_CASE("line_index rejects corrupt files") {
+  thread_pool pool;
+  auto const text = std::string{"a\nbb\nccc\n"};
+  auto const hash = line_index::content_hash(pool, text);
+  auto const path =
+      (std::filesystem::temp_directory_path() / "utl_line_index_corrupt.idx")
+          .string();
+
+  auto const write_raw = [&](line_index::header const& h,
+                             std::vector<std::uint64_t> const& offsets) {
+    auto f = file{path.c_str(), "w+"};
+    f.write(&h, sizeof(h));
+    f.write(offsets.data(), offsets.size() * sizeof(std::uint64_t));
+  };
+  auto h = line_index::header{};
+  std::memcpy(h.magic_, line_index::kMagic, sizeof(line_index::kMagic));
+  h.data_size_ = text.size();
+  h.data_hash_ = hash;
+
+  h.n_lines_ = 3U;
+  write_raw(h, {0U, 2U, 5U, 9U});
+  CHECK(line_index::load(path.c_str(), text.size(), hash).has_value());
+
+  write_raw(h, {0U, 5U, 2U, 9U});  // not increasing
+  CHECK(!line_index::load(path.c_str(), text.size(), hash).has_value());
+
+  write_raw(h, {0U, 2U, 5U, 100U});  // out of bounds
+  CHECK(!line_index::load(path.c_str(), text.size(), hash).has_value());
+
+  h.n_lines_ = std::numeric_limits<std::uint64_t>::max();  // wraps
+  write_raw(h, {0U, 2U, 5U, 9U});
+  CHECK(!line_index::load(path.c_str(), text.size(), hash).has_value());
+
+  std::filesystem::remove(path);
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "catch2/catch_all.hpp"
+
+#include <cstdio>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "utl/parser/mmap_reader.h"
+
+using namespace utl;
+
+TEST_CASE("mmap_reader options") {
+  auto const path =
+      (std::filesystem::temp_directory_path() / "utl_mmap_reader_test.txt")
+          .string();
+
+  auto expected = std::vector<std::string>{};
+  {
+    auto const f = std::fopen(path.c_str(), "wb");
+    REQUIRE(f != nullptr);
+    for (auto i = 0U; i != 20000U; ++i) {
+      expected.emplace_back(std::to_string(i * 7919U) +
+                            std::string(i % 13U, 'x'));
+      std::fputs((expected.back() + "\n").c_str(), f);
+    }
+    std::fclose(f);
+  }
+
+  auto opt = mmap_options{};
+  opt.sequential_ = true;
+  opt.will_need_ = true;
+  opt.populate_ = true;
+  opt.huge_pages_ = true;
+  for (auto const release_behind : {0U, 1U, 4096U, 100000U}) {
+    opt.release_behind_ = release_behind;
+    auto r = mmap_reader{path.c_str(), opt};
+    auto lines = std::vector<std::string>{};
+    for (auto line = r.read_line(); line.str != nullptr;
+         line = r.read_line()) {
+      lines.emplace_back(line.view());
+    }
+    CHECK(lines == expected);
+    CHECK(r.progress() == 1.0F);
+  }
+
+  std::filesystem::remove(path);
+}
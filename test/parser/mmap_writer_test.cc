@@ -0,0 +1,63 @@
+#include "catch2/catch_all.hpp"
+
+#include <cctype>
+#include <cstdlib>
+
+#include <filesystem>
+#include <string>
+
+#include "utl/parser/file.h"
+#include "utl/parser/mmap_reader.h"
+#include "utl/parser/mmap_writer.h"
+
+using namespace utl;
+
+TEST_CASE("mmap_writer file to file") {
+  auto dir_template =
+      (std::filesystem::temp_directory_path() / "utl_mmap_writer_XXXXXX")
+          .string();
+  REQUIRE(mkdtemp(dir_template.data()) != nullptr);
+  auto const tmp = std::filesystem::path{dir_template};
+  auto const in_path = (tmp / "in.txt").string();
+  auto const out_path = (tmp / "out.txt").string();
+
+  auto input = std::string{};
+  for (auto i = 0U; i != 5000U; ++i) {
+    input += "line " + std::to_string(i) + "\n";
+  }
+  {
+    auto w = mmap_writer{in_path.c_str(), mmap_sync::kAsyncOnGrow, 4096U};
+    w.write(cstr{input});
+    CHECK(w.size() == input.size());
+  }
+  CHECK(file{in_path.c_str(), "r"}.content_str() == input);
+
+  for (auto const sync : {mmap_sync::kNone, mmap_sync::kAsyncOnGrow,
+                          mmap_sync::kSyncOnClose}) {
+    auto r = mmap_reader{in_path.c_str()};
+    auto w = mmap_writer{out_path.c_str(), sync, 4096U};
+    for (auto line = r.read_line(); line.str != nullptr;
+         line = r.read_line()) {
+      auto const out = w.reserve(line.len);
+      for (auto i = 0U; i != line.len; ++i) {
+        out[i] = static_cast<char>(std::toupper(line[i]));
+      }
+      w.commit(line.len);
+      w.write('\n');
+    }
+    w.close();
+
+    auto expected = input;
+    for (auto& c : expected) {
+      c = static_cast<char>(std::toupper(c));
+    }
+    CHECK(file{out_path.c_str(), "r"}.content_str() == expected);
+  }
+
+  {
+    auto w = mmap_writer{out_path.c_str()};
+  }
+  CHECK(std::filesystem::file_size(out_path) == 0U);
+
+  std::filesystem::remove_all(tmp);
+}
@@ -0,0 +1,117 @@
+#include "catch2/catch_all.hpp"
+
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "utl/parser/buf_reader.h"
+#include "utl/parser/grep.h"
+#include "utl/parser/line_range.h"
+#include "utl/parser/multi_matcher.h"
+#include "utl/pipes/vec.h"
+
+using namespace utl;
+
+namespace {
+
+using match = std::pair<pattern_id, std::size_t>;
+
+std::vector<match> brute_force(std::vector<std::string> const& patterns,
+                               std::string const& s) {
+  auto matches = std::vector<match>{};
+  for (auto id = pattern_id{0U}; id != patterns.size(); ++id) {
+    for (auto pos = s.find(patterns[id]); pos != std::string::npos;
+         pos = s.find(patterns[id], pos + 1U)) {
+      matches.emplace_back(id, pos);
+    }
+  }
+  std::sort(begin(matches), end(matches));
+  return matches;
+}
+
+std::vector<match> all_matches(multi_matcher const& m, std::string const& s,
+                               bool const automaton) {
+  auto matches = std::vector<match>{};
+  auto const collect = [&](pattern_id const id, std::size_t const pos) {
+    matches.emplace_back(id, pos);
+  };
+  if (automaton) {
+    m.for_each_match_automaton(cstr{s}, collect);
+  } else {
+    m.for_each_match(cstr{s}, collect);
+  }
+  std::sort(begin(matches), end(matches));
+  return matches;
+}
+
+}  // namespace
+
+TEST_CASE("multi_matcher") {
+  auto const patterns =
+      std::vector<std::string>{"he", "she", "his", "hers", "error", "e"};
+  auto const m = multi_matcher{patterns};
+  auto const s = std::string{"ushers error: she said his errors"};
+  CHECK(all_matches(m, s, false) == brute_force(patterns, s));
+  CHECK(all_matches(m, s, true) == brute_force(patterns, s));
+
+  auto ids = std::vector<pattern_id>{};
+  m.find_all("ushers", ids);
+  CHECK(ids == std::vector<pattern_id>{0U, 1U, 3U, 5U});
+  CHECK(m.matches("xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxhisxx"));
+  CHECK(!m.matches("xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"));
+  CHECK(!m.matches(""));
+}
+
+TEST_CASE("multi_matcher random") {
+  auto rng = std::mt19937{42U};
+  auto const random_string = [&](std::size_t const len) {
+    auto s = std::string(len, ' ');
+    for (auto& c : s) {
+      c = static_cast<char>('a' + rng() % 4U);
+    }
+    return s;
+  };
+
+  for (auto const n_patterns : {1U, 3U, 8U, 32U, 33U, 200U}) {
+    auto patterns = std::vector<std::string>{};
+    for (auto i = 0U; i != n_patterns; ++i) {
+      patterns.emplace_back(random_string(1U + rng() % 6U));
+    }
+    auto const m = multi_matcher{patterns};
+    for (auto const len : {0U, 1U, 5U, 31U, 32U, 33U, 34U, 35U, 100U, 500U}) {
+      auto const s = random_string(len);
+      auto const expected = brute_force(patterns, s);
+      CHECK(all_matches(m, s, false) == expected);
+      CHECK(all_matches(m, s, true) == expected);
+    }
+  }
+}
+
+TEST_CASE("multi_matcher binary") {
+  auto const patterns = std::vector<std::string>{
+      std::string{"\0\xFF", 2U}, "\x80\x81\x82", std::string{"a\0", 2U}};
+  auto const m = multi_matcher{patterns};
+  auto s = std::string(100U, '\0');
+  s.replace(40U, 3U, "\x80\x81\x82");
+  s[98] = 'a';
+  CHECK(all_matches(m, s, false) == brute_force(patterns, s));
+  CHECK(all_matches(m, s, true) == brute_force(patterns, s));
+}
+
+TEST_CASE("grep") {
+  constexpr auto const input =
+      "INFO start\n"
+      "WARN disk almost full\n"
+      "ERROR disk full\n"
+      "INFO done\n";
+
+  auto const matches = line_range{buf_reader{input}}  //
+                       | grep({"ERROR", "WARN", "full"})  //
+                       | vec();
+  REQUIRE(matches.size() == 2U);
+  CHECK(matches[0].line_ == "WARN disk almost full");
+  CHECK(matches[0].ids_ == std::vector<pattern_id>{1U, 2U});
+  CHECK(matches[1].line_ == "ERROR disk full");
+  CHECK(matches[1].ids_ == std::vector<pattern_id>{0U, 2U});
+}
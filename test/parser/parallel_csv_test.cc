@@ -0,0 +1,81 @@
+#include "catch2/catch_all.hpp"
+
+#include <mutex>
+#include <string>
+
+#include "utl/parser/parallel_csv.h"
+
+using namespace utl;
+
+namespace {
+
+struct row {
+  csv_col<int, UTL_NAME("id")> id_;
+  csv_col<std::string, UTL_NAME("text")> text_;
+  csv_col<double, UTL_NAME("value")> value_;
+};
+
+std::string make_input(int const n_rows) {
+  auto s = std::string{"value,id,text\r\n"};
+  for (auto i = 0; i != n_rows; ++i) {
+    s += std::to_string(i) + ".5," + std::to_string(i) + ",";
+    switch (i % 4) {
+      case 0: s += "plain"; break;
+      case 1: s += "\"quoted, with separator\""; break;
+      case 2: s += "\"multi\nline\""; break;
+      case 3: s += "\"\"\"escaped\"\"\nquote\""; break;
+    }
+    s += "\r\n";
+  }
+  return s;
+}
+
+}  // namespace
+
+TEST_CASE("parallel_csv ordered") {
+  auto const input = make_input(1000);
+  thread_pool pool;
+
+  for (auto const chunk_size : {0U, 1U, 7U, 64U, 1000U, 1U << 20U}) {
+    auto const rows = parallel_csv<row>(pool, input, chunk_size);
+    REQUIRE(rows.size() == 1000U);
+    for (auto i = 0; i != 1000; ++i) {
+      CHECK(rows[i].id_.val() == i);
+      CHECK(rows[i].value_.val() == i + 0.5);
+      switch (i % 4) {
+        case 0: CHECK(rows[i].text_.val() == "plain"); break;
+        case 1: CHECK(rows[i].text_.val() == "quoted, with separator"); break;
+        case 2: CHECK(rows[i].text_.val() == "multi\nline"); break;
+        case 3: CHECK(rows[i].text_.val() == "\"\"escaped\"\"\nquote"); break;
+      }
+    }
+  }
+}
+
+TEST_CASE("parallel_csv batches") {
+  auto const input = make_input(500);
+  thread_pool pool;
+
+  std::mutex m;
+  auto n_rows = std::size_t{0U};
+  auto id_sum = 0;
+  parallel_csv_batches<row>(
+      pool, input,
+      [&](std::vector<row>&& batch) {
+        std::lock_guard<std::mutex> const lock{m};
+        n_rows += batch.size();
+        for (auto const& r : batch) {
+          id_sum += r.id_.val();
+        }
+      },
+      100U);
+
+  CHECK(n_rows == 500U);
+  CHECK(id_sum == 499 * 500 / 2);
+}
+
+TEST_CASE("parallel_csv empty") {
+  thread_pool pool;
+  CHECK(parallel_csv<row>(pool, cstr{"value,id,text"}).empty());
+  CHECK(parallel_csv<row>(pool, cstr{""}).empty());
+}
@@ -0,0 +1,98 @@
+#include "catch2/catch_all.hpp"
+
+#include <cstdio>
+
+#include <filesystem>
+#include <atomic>
+#include <map>
+#include <random>
+#include <string>
+
+#include "utl/parser/arg_parser.h"
+#include "utl/parser/parallel_for_each_line.h"
+
+using namespace utl;
+
+namespace {
+
+using histogram = std::map<std::size_t, std::size_t>;
+
+histogram length_histogram(thread_pool& pool, cstr const data,
+                           std::size_t const chunk_size) {
+  return parallel_for_each_line(
+      pool, data, [] { return histogram{}; },
+      [](histogram& h, cstr const line) { ++h[line.len]; },
+      [](histogram& into, histogram&& from) {
+        for (auto const& [len, count] : from) {
+          into[len] += count;
+        }
+      },
+      chunk_size);
+}
+
+}  // namespace
+
+TEST_CASE("parallel_for_each_line") {
+  auto input = std::string{};
+  for (auto i = 0U; i != 1000U; ++i) {
+    input += std::string(i % 17U, 'x') + (i % 3U == 0U ? "\r\n" : "\n");
+  }
+  input += "last";
+
+  auto expected = histogram{};
+  for_each_line(input, [&](cstr const line) { ++expected[line.len]; });
+
+  thread_pool pool;
+  for (auto const chunk_size : {1U, 7U, 100U, 1000000U}) {
+    CHECK(length_histogram(pool, input, chunk_size) == expected);
+  }
+  CHECK(length_histogram(pool, cstr{}, 10U).empty());
+
+  auto const n_lines = parallel_for_each_line(
+      pool, "a\n\nb\n", [] { return 0U; },
+      [](unsigned& n, cstr) { ++n; }, [](unsigned& a, unsigned b) { a += b; },
+      1U);
+  CHECK(n_lines == 3U);
+
+  auto n_states = std::atomic_size_t{0U};
+  parallel_for_each_line(
+      pool, cstr{input}, [&] { return ++n_states; }, [](std::size_t&, cstr) {},
+      [](std::size_t&, std::size_t) {}, 1U);
+  CHECK(n_states <= pool.size());
+}
+
+TEST_CASE("parallel_for_each_line file") {
+  auto rng = std::random_device{};
+  auto tmp = std::filesystem::path{};
+  do {
+    tmp = std::filesystem::temp_directory_path() /
+          ("utl_parallel_lines_" + std::to_string(rng()));
+  } while (!std::filesystem::create_directory(tmp));
+  auto const path = (tmp / "lines.txt").string();
+  auto input = std::string{};
+  for (auto i = 0U; i != 500U; ++i) {
+    input += std::to_string(i) + "\n";
+  }
+  {
+    auto const f = std::fopen(path.c_str(), "wb");
+    REQUIRE(f != nullptr);
+    std::fwrite(input.data(), 1U, input.size(), f);
+    std::fclose(f);
+  }
+
+  thread_pool pool;
+  auto const sum = parallel_for_each_line_in_file(
+      pool, path, [] { return 0U; },
+      [](unsigned& s, cstr const line) { s += parse<unsigned>(line); },
+      [](unsigned& a, unsigned b) { a += b; }, 64U);
+  CHECK(sum == 499U * 500U / 2U);
+
+  auto const empty_path = (tmp / "empty.txt").string();
+  std::fclose(std::fopen(empty_path.c_str(), "wb"));
+  auto const n_lines = parallel_for_each_line_in_file(
+      pool, empty_path, [] { return 7U; },
+      [](unsigned& n, cstr) { ++n; }, [](unsigned& a, unsigned b) { a += b; });
+  CHECK(n_lines == 7U);
+
+  std::filesystem::remove_all(tmp);
+}
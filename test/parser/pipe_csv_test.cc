@@ -1,6 +1,7 @@
 #include "catch2/catch_all.hpp"
 
 #include "utl/parser/buf_reader.h"
+#include "utl/parser/csv_columns.h"
 #include "utl/parser/csv_range.h"
 #include "utl/parser/line_range.h"
 #include "utl/pipes/avg.h"
@@ -50,7 +51,7 @@ TEST_CASE("csv_no_rows") {
 
   {
     constexpr auto const no_rows_input = R"(FOO,BAR)";
-    auto const result = line_range<buf_reader>{buf_reader{no_rows_input}}  //
+    auto const result = line_range<buf_reader<>>{buf_reader{no_rows_input}}  //
                         | csv<baz>()  //
                         | vec();
 
@@ -60,7 +61,7 @@ TEST_CASE("csv_no_rows") {
     constexpr auto const no_rows_input = R"(FOO,BAR
 
 )";
-    auto const result = line_range<buf_reader>{buf_reader{no_rows_input}}  //
+    auto const result = line_range<buf_reader<>>{buf_reader{no_rows_input}}  //
                         | csv<baz>()  //
                         | vec();
 
@@ -77,7 +78,7 @@ TEST_CASE("csv_separator") {
   constexpr auto const no_rows_input = R"(BAR$FOO
 1$2
 )";
-  auto const result = line_range<buf_reader>{buf_reader{no_rows_input}}  //
+  auto const result = line_range<buf_reader<>>{buf_reader{no_rows_input}}  //
                       | csv<baz, '$'>()  //
                       | vec();
 
@@ -96,7 +97,7 @@ TEST_CASE("csv_escaped_string") {
   constexpr auto const input = R"(BAR,FOO,BAZ
 "asd","[""asd"", ""bsd""]","xxx"
 )";
-  auto const result = line_range<buf_reader>{buf_reader{input}}  //
+  auto const result = line_range<buf_reader<>>{buf_reader{input}}  //
                       | csv<dat, ','>()  //
                       | vec();
 
@@ -105,3 +106,212 @@ TEST_CASE("csv_escaped_string") {
   CHECK(result[0].bar_.val() == "asd");
   CHECK(result[0].baz_.val() == "xxx");
 }
+
+TEST_CASE("csv_simd") {
+  auto const avg_volume =
+      line_range{buf_reader{input}}  //
+      | csv<quote, ',', simd>()  //
+      | remove_if([](auto&& row) { return row.open_ < 39.01; })  //
+      | transform([](auto&& row) { return row.volume_; })  //
+      | avg();
+  CHECK(avg_volume <= 65844.5);
+  CHECK(avg_volume >= 65844.3);
+}
+
+TEST_CASE("csv_simd_quoted_separator") {
+  struct dat {
+    csv_col<std::string, UTL_NAME("FOO")> foo_;
+    csv_col<std::string, UTL_NAME("BAR")> bar_;
+    csv_col<int, UTL_NAME("BAZ")> baz_;
+  };
+
+  constexpr auto const input =
+      "BAR,FOO,BAZ\r\n"
+      "\"asd\",\"[\"\"asd\"\", \"\"bsd\"\"]\",1\r\n"
+      "\"a,b\",\"this field is long enough to cross the 64 byte block "
+      "boundary, including a separator\",2\r\n"
+      "x,,3\r\n";
+
+  auto const scalar_result = line_range{buf_reader{input}}  //
+                             | csv<dat>()  //
+                             | vec();
+  auto const simd_result = line_range{buf_reader{input}}  //
+                           | csv<dat, ',', simd>()  //
+                           | vec();
+
+  REQUIRE(simd_result.size() == 3);
+  REQUIRE(scalar_result.size() == simd_result.size());
+  for (auto i = 0U; i != simd_result.size(); ++i) {
+    CHECK(simd_result[i].foo_.val() == scalar_result[i].foo_.val());
+    CHECK(simd_result[i].bar_.val() == scalar_result[i].bar_.val());
+    CHECK(simd_result[i].baz_.val() == scalar_result[i].baz_.val());
+  }
+  CHECK(simd_result[0].foo_.val() == R"([""asd"", ""bsd""])");
+  CHECK(simd_result[1].bar_.val() == "a,b");
+  CHECK(simd_result[2].bar_.val() == "x");
+  CHECK(simd_result[2].foo_.val().empty());
+  CHECK(simd_result[2].baz_.val() == 3);
+}
+
+TEST_CASE("csv_columns") {
+  auto const columns = line_range{buf_reader{input}}  //
+                       | csv_columns<quote>();
+
+  REQUIRE(columns.size() == 9U);
+  auto const& open = columns.get<0>();
+  auto const& volume = columns.get<4>();
+  auto const& time = columns.get<6>();
+  static_assert(std::is_same_v<decltype(open), std::vector<float> const&>);
+  static_assert(std::is_same_v<decltype(volume), std::vector<int> const&>);
+  REQUIRE(volume.size() == 9U);
+  CHECK(open[1] == 39.0F);
+  CHECK(volume[0] == 179332);
+  CHECK(volume[8] == 29713);
+  CHECK(time[8] == cstr{"09:38"});
+}
+
+TEST_CASE("csv_rows") {
+  auto const big_volume =
+      line_range{buf_reader{input}}  //
+      | csv_rows<quote>()  //
+      | remove_if([](csv_row<quote> const& row) {
+          return row.get<4>() < 40000;
+        })  //
+      | transform([](csv_row<quote> const& row) { return row.materialize(); })
+      | vec();
+
+  static_assert(std::is_same_v<csv_field_t<quote, 4>, int>);
+  static_assert(std::is_same_v<csv_field_t<quote, 6>, cstr>);
+  REQUIRE(big_volume.size() == 3U);
+  CHECK(big_volume[0].volume_.val() == 179332);
+  CHECK(big_volume[1].volume_.val() == 44967);
+  CHECK(big_volume[2].volume_.val() == 62365);
+  CHECK(big_volume[2].time_.val() == "09:35");
+  CHECK(big_volume[2].open_.val() == 39.02F);
+
+  auto const times = line_range{buf_reader{input}}  //
+                     | csv_rows<quote, ',', simd>()  //
+                     | transform([](csv_row<quote> const& row) {
+                         return row.raw<6>().to_str();
+                       })  //
+                     | vec();
+  REQUIRE(times.size() == 9U);
+  CHECK(times[0] == "09:30");
+  CHECK(times[8] == "09:38");
+}
+
+TEST_CASE("csv_wide") {
+  struct wide {
+    csv_col<int, UTL_NAME("c3")> c3_;
+    csv_col<int, UTL_NAME("c99")> c99_;
+    csv_col<std::string, UTL_NAME("c139")> c139_;
+    csv_col<int, UTL_NAME("c40")> c40_;
+  };
+
+  auto s = std::string{};
+  for (auto col = 0; col != 140; ++col) {
+    s += (col == 0 ? "" : ",") + ("c" + std::to_string(col));
+  }
+  for (auto row = 0; row != 3; ++row) {
+    s += '\n';
+    for (auto col = 0; col != 140; ++col) {
+      s += (col == 0 ? "" : ",") + std::to_string(row * 1000 + col);
+    }
+  }
+
+  auto const check = [](std::vector<wide> const& rows) {
+    REQUIRE(rows.size() == 3U);
+    CHECK(rows[2].c3_.val() == 2003);
+    CHECK(rows[2].c40_.val() == 2040);
+    CHECK(rows[2].c99_.val() == 2099);
+    CHECK(rows[2].c139_.val() == "2139");
+  };
+  check(line_range{buf_reader{s}} | csv<wide>() | vec());
+  check(line_range{buf_reader{s}} | csv<wide, ',', simd>() | vec());
+
+  struct narrow {
+    csv_col<int, UTL_NAME("c40")> c40_;
+    csv_col<int, UTL_NAME("c1")> c1_;
+  };
+  auto const rows =
+      line_range{buf_reader{s}} | csv<narrow, ',', simd>() | vec();
+  REQUIRE(rows.size() == 3U);
+  CHECK(rows[1].c1_.val() == 1001);
+  CHECK(rows[1].c40_.val() == 1040);
+}
+
+TEST_CASE("csv_header_alias_ignore_case") {
+  struct dat {
+    csv_col<int, UTL_NAME("id"), UTL_ALIAS("stop_id"), UTL_ALIAS("sid")> id_;
+    csv_col<int, UTL_NAME("lat"), csv_ignore_case> lat_;
+    csv_col<int, UTL_NAME("lon")> lon_;
+  };
+
+  auto const rows = line_range{buf_reader{"LAT,Lon,stop_id\n1,2,3\n"}}  //
+                    | csv<dat>()  //
+                    | vec();
+  REQUIRE(rows.size() == 1U);
+  CHECK(rows[0].id_.val() == 3);
+  CHECK(rows[0].lat_.val() == 1);
+  CHECK(rows[0].lon_.val() == 0);
+
+  auto const perm = read_header<dat>("ID,sid,lon,Lat,\"id\"");
+  REQUIRE(perm.size() == 5U);
+  CHECK(perm[0] == NO_COLUMN_IDX);
+  CHECK(perm[1] == 0U);
+  CHECK(perm[2] == 2U);
+  CHECK(perm[3] == 1U);
+  CHECK(perm[4] == 0U);
+}
+
+TEST_CASE("csv_header_many_names") {
+  struct gtfs {
+    csv_col<int, UTL_NAME("stop_id"), UTL_ALIAS("stop_code"),
+            UTL_ALIAS("platform_code"), UTL_ALIAS("level_id")>
+        stop_;
+    csv_col<int, UTL_NAME("trip_id"), UTL_ALIAS("trip_headsign"),
+            UTL_ALIAS("trip_short_name"), UTL_ALIAS("block_id")>
+        trip_;
+    csv_col<int, UTL_NAME("route_id"), UTL_ALIAS("route_short_name"),
+            UTL_ALIAS("route_long_name"), UTL_ALIAS("route_desc")>
+        route_;
+    csv_col<int, UTL_NAME("route_type"), UTL_ALIAS("route_url"),
+            UTL_ALIAS("route_color"), UTL_ALIAS("route_text_color")>
+        route_type_;
+    csv_col<int, UTL_NAME("service_id"), UTL_ALIAS("monday"),
+            UTL_ALIAS("tuesday"), UTL_ALIAS("wednesday")>
+        service_;
+    csv_col<int, UTL_NAME("arrival_time"), UTL_ALIAS("departure_time"),
+            UTL_ALIAS("stop_sequence"), UTL_ALIAS("stop_headsign")>
+        time_;
+    csv_col<int, UTL_NAME("pickup_type"), UTL_ALIAS("drop_off_type"),
+            UTL_ALIAS("timepoint"), UTL_ALIAS("shape_dist_traveled")>
+        pickup_;
+    csv_col<int, UTL_NAME("stop_lat"), UTL_ALIAS("stop_lon"),
+            UTL_ALIAS("zone_id"), UTL_ALIAS("stop_url"), csv_ignore_case>
+        pos_;
+    csv_col<int, UTL_NAME("agency_id"), UTL_ALIAS("agency_name"),
+            UTL_ALIAS("agency_url"), UTL_ALIAS("agency_timezone")>
+        agency_;
+    csv_col<int, UTL_NAME("shape_id"), UTL_ALIAS("shape_pt_lat"),
+            UTL_ALIAS("shape_pt_lon"), UTL_ALIAS("shape_pt_sequence")>
+        shape_;
+    csv_col<int, UTL_NAME("ID")> upper_id_;
+    csv_col<int, UTL_NAME("id")> lower_id_;
+  };
+
+  auto const perm = read_header<gtfs>(
+      "wednesday,STOP_URL,shape_pt_sequence,id,ID,Id,route_text_color,"
+      "unknown,agency_timezone,timepoint,stop_headsign,block_id,level_id");
+  CHECK(perm == csv_permutation{4U, 7U, 9U, 11U, 10U, NO_COLUMN_IDX, 3U,
+                                NO_COLUMN_IDX, 8U, 6U, 5U, 1U, 0U});
+
+  auto const rows =
+      line_range{buf_reader{"id,route_long_name,ID\n1,2,3\n"}}  //
+      | csv<gtfs>()  //
+      | vec();
+  REQUIRE(rows.size() == 1U);
+  CHECK(rows[0].lower_id_.val() == 1);
+  CHECK(rows[0].route_.val() == 2);
+  CHECK(rows[0].upper_id_.val() == 3);
+}
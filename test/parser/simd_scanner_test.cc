@@ -0,0 +1,98 @@
+#include "catch2/catch_all.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "utl/parser/cstr.h"
+#include "utl/parser/simd_scanner.h"
+
+using namespace utl;
+
+namespace {
+
+std::string random_input(std::size_t const size, unsigned const seed) {
+  auto gen = std::mt19937{seed};
+  auto dist = std::uniform_int_distribution<int>{0, 7};
+  auto s = std::string{};
+  for (auto i = 0U; i != size; ++i) {
+    auto const x = dist(gen);
+    s.push_back(x == 0 ? ',' : (x == 1 ? '\n' : static_cast<char>('a' + x)));
+  }
+  return s;
+}
+
+std::vector<std::string> naive_tokens(cstr s, char const sep) {
+  std::vector<std::string> tokens;
+  while (s.len > 0) {
+    auto const token = get_until(s, sep);
+    tokens.emplace_back(token.view());
+    s += token.len;
+    if (s.len != 0) {
+      ++s;
+    }
+  }
+  return tokens;
+}
+
+}  // namespace
+
+TEST_CASE("scan_block kernels agree") {
+  auto const input = random_input(kBlockSize, 42U);
+  auto const needles = std::array<char, 2U>{',', '\n'};
+
+  block_masks<2U> expected;
+  detail::scan_block_scalar<2U>(input.data(), needles, expected);
+
+  block_masks<2U> actual;
+  get_block_scan_fn<2U>()(input.data(), needles, actual);
+  CHECK(actual == expected);
+
+  for (auto i = 0U; i != kBlockSize; ++i) {
+    CHECK(((expected[0] >> i) & 1U) == (input[i] == ',' ? 1U : 0U));
+    CHECK(((expected[1] >> i) & 1U) == (input[i] == '\n' ? 1U : 0U));
+  }
+}
+
+TEST_CASE("block_scanner finds all positions") {
+  for (auto const size : {0U, 1U, 63U, 64U, 65U, 127U, 128U, 1000U}) {
+    auto const input = random_input(size, size);
+    auto scanner = block_scanner<2U>{input.data(), input.size(), {',', '\n'}};
+    for (auto i = 0U; i != input.size(); ++i) {
+      if (input[i] == ',' || input[i] == '\n') {
+        REQUIRE(scanner.next() == input.data() + i);
+      }
+    }
+    CHECK(scanner.next() == input.data() + input.size());
+    CHECK(scanner.next() == input.data() + input.size());
+  }
+}
+
+TEST_CASE("for_each_token matches get_until") {
+  for (auto const size : {0U, 1U, 63U, 64U, 65U, 200U, 4096U}) {
+    auto const input = random_input(size, size + 1U);
+    std::vector<std::string> tokens;
+    for_each_token(input, ',', [&](cstr t) { tokens.emplace_back(t.view()); });
+    CHECK(tokens == naive_tokens(input, ','));
+  }
+}
+
+TEST_CASE("for_each_token trailing separator") {
+  std::vector<std::string> tokens;
+  for_each_token(",a,,b,", ',',
+                 [&](cstr t) { tokens.emplace_back(t.view()); });
+  CHECK(tokens == std::vector<std::string>{"", "a", "", "b"});
+}
+
+TEST_CASE("lines across block boundaries") {
+  auto const input = random_input(1000U, 7U);
+  std::vector<std::string> expected;
+  for_each_line(input, [&](cstr l) { expected.emplace_back(l.view()); });
+
+  std::vector<std::string> actual;
+  for (auto const l : lines{input}) {
+    actual.emplace_back(l.view());
+  }
+  CHECK(actual == expected);
+  CHECK(expected == naive_tokens(input, '\n'));
+}
@@ -0,0 +1,52 @@
+#include "catch2/catch_all.hpp"
+
+#include <string>
+
+#include "utl/parser/split.h"
+
+using namespace utl;
+
+TEST_CASE("split") {
+  auto const [a, b, c] =
+      split<',', int, std::string, cstr>(R"(1,"x,""y""",z)");
+  CHECK(a == 1);
+  CHECK(b == R"(x,""y"")");
+  CHECK(c == "z");
+}
+
+TEST_CASE("split_no_quote") {
+  auto const [a, b, c] =
+      split_with<split_no_quote, '\t', int, cstr, double>("12\tabc\t1.5");
+  CHECK(a == 12);
+  CHECK(b == "abc");
+  CHECK(c == 1.5);
+
+  auto const [d, e, f] =
+      split_with<split_no_quote, '\t', cstr, cstr, cstr>("a\t\"b\"");
+  CHECK(d == "a");
+  CHECK(e == "\"b\"");
+  CHECK(f.len == 0U);
+
+  auto const [g, h] = split_with<split_no_quote, '\t', cstr, cstr>("x\ty\tz");
+  CHECK(g == "x");
+  CHECK(h == "y");
+}
+
+TEST_CASE("split_fixed") {
+  auto const long_cell = std::string(100U, 'x');
+  auto const line = "1\t" + long_cell + "\t" + long_cell + "\t2.5";
+  auto const [a, b, c, d] =
+      split_with<split_fixed, '\t', int, cstr, std::string, float>(line);
+  CHECK(a == 1);
+  CHECK(b == long_cell);
+  CHECK(c == long_cell);
+  CHECK(d == 2.5F);
+
+  auto const [e, f] = split_with<split_fixed, '\t', cstr, cstr>("x\ty\tz");
+  CHECK(e == "x");
+  CHECK(f == "y\tz");
+
+  auto const [g, h] = split_with<split_fixed, '\t', cstr, cstr>("");
+  CHECK(g.len == 0U);
+  CHECK(h.len == 0U);
+}
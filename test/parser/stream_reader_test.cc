@@ -0,0 +1,119 @@
+#include "catch2/catch_all.hpp"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <limits>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utl/parser/csv_range.h"
+#include "utl/parser/line_range.h"
+#include "utl/parser/stream_reader.h"
+#include "utl/pipes/vec.h"
+
+using namespace utl;
+
+namespace {
+
+#ifdef _WIN32
+int make_pipe(int* fds) { return _pipe(fds, 4096U, _O_BINARY); }
+bool write_all(int const fd, char const* data, std::size_t const n) {
+  return _write(fd, data, static_cast<unsigned>(n)) == static_cast<int>(n);
+}
+void close_fd(int const fd) { _close(fd); }
+#else
+int make_pipe(int* fds) { return pipe(fds); }
+bool write_all(int const fd, char const* data, std::size_t const n) {
+  return write(fd, data, n) == static_cast<ssize_t>(n);
+}
+void close_fd(int const fd) { close(fd); }
+#endif
+
+// Writes s to a pipe in small pieces from another thread.
+struct pipe_writer {
+  explicit pipe_writer(std::string s) : s_{std::move(s)} {
+    REQUIRE(make_pipe(fds_) == 0);
+    t_ = std::thread{[this]() {
+      for (auto pos = std::size_t{0U}; pos < s_.size(); pos += 7U) {
+        auto const n = std::min(std::size_t{7U}, s_.size() - pos);
+        CHECK(write_all(fds_[1], s_.data() + pos, n));
+      }
+      close_fd(fds_[1]);
+    }};
+  }
+
+  ~pipe_writer() {
+    t_.join();
+    close_fd(fds_[0]);
+  }
+
+  int read_fd() const { return fds_[0]; }
+
+  std::string s_;
+  int fds_[2];
+  std::thread t_;
+};
+
+}  // namespace
+
+TEST_CASE("stream_reader lines") {
+  auto const long_line = std::string(100U, 'x');
+  auto const input = "a\n\nbc\r\n" + long_line + "\ndef";
+
+  for (auto const block_size : {1U, 3U, 16U, 1024U}) {
+    auto w = pipe_writer{input};
+    auto r = stream_reader{w.read_fd(), block_size};
+
+    std::vector<std::string> lines;
+    for (auto line = r.read_line(); line.valid() || line.str != nullptr;
+         line = r.read_line()) {
+      lines.emplace_back(line.view());
+    }
+    CHECK(lines ==
+          std::vector<std::string>{"a", "", "bc\r", long_line, "def"});
+  }
+}
+
+TEST_CASE("stream_reader csv") {
+  struct row {
+    csv_col<int, UTL_NAME("a")> a_;
+    csv_col<std::string, UTL_NAME("b")> b_;
+  };
+
+  auto input = std::string{"b,a\n"};
+  for (auto i = 0; i != 1000; ++i) {
+    input += "text" + std::to_string(i) + "," + std::to_string(i) + "\n";
+  }
+
+  auto w = pipe_writer{input};
+  auto const rows =
+      line_range{stream_reader{w.read_fd(), 64U}} | csv<row>() | vec();
+  REQUIRE(rows.size() == 1000U);
+  CHECK(rows[999].a_.val() == 999);
+  CHECK(rows[999].b_.val() == "text999");
+}
+
+#ifndef _WIN32
+TEST_CASE("stream_reader closes file if constructor throws") {
+  auto const probe = open("/dev/null", O_RDONLY | O_CLOEXEC);
+  REQUIRE(probe != -1);
+  close(probe);
+
+  CHECK_THROWS_AS(
+      stream_reader("/dev/null", std::numeric_limits<std::size_t>::max() / 4U),
+      std::bad_alloc);
+
+  // The lowest free descriptor is reused: nothing leaked.
+  auto const after = open("/dev/null", O_RDONLY | O_CLOEXEC);
+  CHECK(after == probe);
+  close(after);
+}
+#endif
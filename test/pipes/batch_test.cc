@@ -0,0 +1,73 @@
+#include "catch2/catch_all.hpp"
+
+#include <list>
+#include <numeric>
+#include <vector>
+
+#include "utl/pipes.h"
+
+using namespace utl;
+
+TEST_CASE("batch protocol detection") {
+  auto v = std::vector<int>{1, 2, 3};
+  auto const is_odd = [](int const i) { return i % 2 == 1; };
+  auto const twice = [](int const i) { return 2 * i; };
+
+  CHECK(is_batch_range_v<decltype(all(v))>);
+  CHECK(is_batch_range_v<decltype(iota(0, 10))>);
+  CHECK(is_batch_range_v<decltype(all(v) | transform(twice))>);
+  CHECK(is_batch_range_v<decltype(iota(0, 10) | remove_if(is_odd) |
+                                  transform(twice))>);
+  CHECK_FALSE(is_batch_range_v<decltype(all(v) | unique())>);
+  CHECK_FALSE(is_batch_range_v<decltype(all(v) | unique() |
+                                        transform(twice))>);
+  CHECK_FALSE(is_batch_range_v<decltype(all(v) | take_while(is_odd))>);
+
+  struct big {
+    char data_[1024];
+  };
+  auto const to_big = [](int) { return big{}; };
+  CHECK_FALSE(is_batch_range_v<decltype(all(v) | transform(to_big))>);
+  CHECK((all(v) | transform(to_big) | count([](big const&) { return true; })) ==
+        3U);
+}
+
+TEST_CASE("batch sum and count") {
+  auto v = std::vector<unsigned>(5000U);
+  std::iota(begin(v), end(v), 0U);
+  auto const square = [](unsigned const i) { return i * i; };
+  auto const is_odd = [](unsigned const i) { return i % 2U == 1U; };
+
+  auto expected_sum = std::size_t{0U};
+  auto expected_count = std::size_t{0U};
+  for (auto const i : v) {
+    if (!is_odd(i)) {
+      expected_sum += square(i);
+      expected_count += (square(i) % 3U == 0U) ? 1U : 0U;
+    }
+  }
+
+  CHECK((all(v) | remove_if(is_odd) | transform(square) | sum()) ==
+        expected_sum);
+  CHECK((iota(0U, 5000U) | remove_if(is_odd) | transform(square) | sum()) ==
+        expected_sum);
+  CHECK((iota(0U, 5000U) | remove_if(is_odd) | transform(square) |
+         count([](unsigned const i) { return i % 3U == 0U; })) ==
+        expected_count);
+  CHECK((iota(0U, 5000U) |
+         remove_if([](unsigned const i) { return i < 4000U; }) |
+         count([](unsigned) { return true; })) == 1000U);
+  CHECK((iota(0, 0) | sum()) == 0U);
+  CHECK((iota(5, 0) | sum()) == 0U);
+}
+
+TEST_CASE("batch non random access source") {
+  auto const l = std::list<int>{1, 2, 3, 4, 5};
+  CHECK((all(l) | transform([](int const i) { return i * 10; }) | sum()) ==
+        150U);
+  auto const v = std::vector<int>{1, 2, 3};
+  CHECK((all(v) | transform([](int const i) {
+           return static_cast<double>(i) / 2.0;
+         }) |
+         count([](double const d) { return d >= 1.0; })) == 2U);
+}
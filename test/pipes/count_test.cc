@@ -18,3 +18,9 @@ TEST_CASE("count test int 3") {
   std::vector<int> v = {5, 7, 9, 1, 4, 1, 3, 1, 5, 3, 1};
   CHECK((all(v) | count([](auto&& i) { return i == 10; })) == 0);
 }
+
+TEST_CASE("count test mutable reference predicate") {
+  std::vector<int> v = {1, 2, 3, 4, 5};
+  CHECK((all(v) | count([](int& i) { return ++i % 2 == 1; })) == 2);
+  CHECK(v == std::vector<int>{2, 3, 4, 5, 6});
+}
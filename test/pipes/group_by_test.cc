@@ -0,0 +1,68 @@
+#include "catch2/catch_all.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "utl/pipes.h"
+
+using namespace utl;
+
+TEST_CASE("hash index") {
+  auto idx = hash_index<unsigned>{};
+  for (auto i = 0U; i != 10000U; ++i) {
+    CHECK(idx.insert(i * 16U) == std::pair<std::size_t, bool>{i, true});
+  }
+  for (auto i = 0U; i != 10000U; ++i) {
+    CHECK(idx.insert(i * 16U) == std::pair<std::size_t, bool>{i, false});
+  }
+  CHECK(idx.size() == 10000U);
+}
+
+TEST_CASE("distinct") {
+  auto const v = std::vector<int>{3, 1, 3, 2, 1, 4, 3};
+  CHECK((all(v) | distinct() | vec()) == std::vector<int>{3, 1, 2, 4});
+  CHECK((iota(0, 0) | distinct() | vec()).empty());
+  CHECK((iota(0, 5000) | transform([](int const i) { return i % 7; }) |
+         distinct() | vec()) == std::vector<int>{0, 1, 2, 3, 4, 5, 6});
+}
+
+TEST_CASE("count by") {
+  auto const v = std::vector<std::string>{"b", "a", "b", "c", "b", "a"};
+  auto const counts = all(v) | count_by([](std::string const& s) { return s; });
+  CHECK(counts == std::vector<std::pair<std::string, std::size_t>>{
+                      {"b", 3U}, {"a", 2U}, {"c", 1U}});
+
+  thread_pool pool;
+  auto const mod = [](unsigned const i) { return i % 100U; };
+  auto const expected = iota(0U, 10000U) | count_by(mod);
+  CHECK((iota(0U, 10000U) | par(pool, 333U) | count_by(mod)) == expected);
+  CHECK(expected.size() == 100U);
+  CHECK(expected.front() == std::pair<unsigned, std::size_t>{0U, 100U});
+}
+
+TEST_CASE("group by") {
+  auto const v = std::vector<int>{5, 12, 7, 30, 14, 1};
+  auto const by_tens = [](int const i) { return i / 10; };
+
+  CHECK((all(v) | group_by(by_tens)) ==
+        std::vector<std::pair<int, std::vector<int>>>{
+            {0, {5, 7, 1}}, {1, {12, 14}}, {3, {30}}});
+  CHECK((all(v) | group_by(
+                      by_tens, [](int acc, int const i) { return acc + i; },
+                      0)) ==
+        std::vector<std::pair<int, int>>{{0, 13}, {1, 26}, {3, 30}});
+}
+
+TEST_CASE("group by par") {
+  thread_pool pool;
+  auto const mod = [](unsigned const i) { return i % 10U; };
+  auto const add = [](unsigned acc, unsigned const i) { return acc + i; };
+
+  CHECK((iota(0U, 1000U) | par(pool, 37U) | group_by(mod)) ==
+        (iota(0U, 1000U) | group_by(mod)));
+  CHECK((iota(0U, 1000U) | par(pool, 37U) |
+         group_by(mod, add, 0U,
+                  [](unsigned& a, unsigned const b) { a += b; })) ==
+        (iota(0U, 1000U) | group_by(mod, add, 0U)));
+}
@@ -0,0 +1,81 @@
+#include "catch2/catch_all.hpp"
+
+#include <atomic>
+#include <numeric>
+#include <set>
+#include <vector>
+
+#include "utl/pipes.h"
+
+using namespace utl;
+
+TEST_CASE("par vec") {
+  thread_pool pool;
+  auto v = std::vector<int>(1000U);
+  std::iota(begin(v), end(v), 0);
+
+  auto const expected = all(v)  //
+                        | transform([](int const i) { return i * 3; })  //
+                        | remove_if([](int const i) { return i % 2 == 0; })  //
+                        | vec();
+  for (auto const chunk_size : {0U, 1U, 7U, 5000U}) {
+    auto const result = v  //
+                        | par(pool, chunk_size)  //
+                        | transform([](int const i) { return i * 3; })  //
+                        | remove_if([](int const i) { return i % 2 == 0; })  //
+                        | vec();
+    CHECK(result == expected);
+  }
+
+  CHECK((std::vector<int>{} | par(pool) | vec()).empty());
+  CHECK((std::vector<int>{1, 2, 3} | par(pool, 2U) | vec()) ==
+        std::vector<int>{1, 2, 3});
+}
+
+TEST_CASE("par reducers") {
+  thread_pool pool;
+  auto const square = [](unsigned const i) { return i * i; };
+
+  CHECK((iota(0U, 1000U) | par(pool, 64U) | transform(square) | sum()) ==
+        332833500U);
+  CHECK((iota(0U, 1000U) | par(pool, 64U) |
+         count([](unsigned const i) { return i % 3U == 0U; })) == 334U);
+  CHECK((iota(0, 1001) | par(pool, 10U) | avg()) == 500.0);
+  CHECK((iota(0, 1000) | par(pool, 10U) | max<int>{-1}) == 999.0);
+  CHECK((iota(0U, 100U) | par(pool, 9U) |
+         accumulate([](unsigned acc, unsigned const i) { return acc + i; },
+                    0U, [](unsigned& a, unsigned const b) { a += b; })) ==
+        4950U);
+  CHECK((iota(0U, 100U) | par(pool, 9U) |
+         transform([](unsigned const i) { return i % 10U; }) |
+         to<std::set<unsigned>>())
+            .size() == 10U);
+
+  auto n = std::atomic_size_t{0U};
+  iota(0U, 100U) | par(pool, 9U) | for_each([&](unsigned const i) { n += i; });
+  CHECK(n == 4950U);
+}
+
+TEST_CASE("par holding container") {
+  thread_pool pool;
+  auto const result = std::vector<int>{1, 2, 3, 4, 5}  //
+                      | par(pool, 2U)  //
+                      | transform([](int const i) { return -i; })  //
+                      | vec();
+  CHECK(result == std::vector<int>{-1, -2, -3, -4, -5});
+}
+
+TEST_CASE("par stateful stages") {
+  thread_pool pool;
+  auto v = std::vector<int>{1, 1, 2, 2, 3, 3, 1, 2, 3};
+  auto const is_odd = [](int const i) { return i % 2 == 1; };
+  auto const twice = [](int const i) { return 2 * i; };
+
+  CHECK(is_chunkable_v<decltype(v | par(pool) | transform(twice) |
+                                remove_if(is_odd))>);
+  CHECK_FALSE(is_chunkable_v<decltype(v | par(pool) | unique())>);
+  CHECK_FALSE(is_chunkable_v<decltype(v | par(pool) | distinct())>);
+  CHECK_FALSE(is_chunkable_v<decltype(v | par(pool) | distinct() |
+                                      transform(twice))>);
+  CHECK_FALSE(is_chunkable_v<decltype(v | par(pool) | take_while(is_odd))>);
+}
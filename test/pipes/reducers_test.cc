@@ -0,0 +1,98 @@
+#include "catch2/catch_all.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "utl/pipes.h"
+
+using namespace utl;
+
+TEST_CASE("avg does not truncate") {
+  auto const v = std::vector<double>{0.5, 1.0, 2.0};
+  CHECK((all(v) | avg()) == Catch::Approx(3.5 / 3.0));
+
+  auto const big = std::vector<std::int64_t>{
+      std::numeric_limits<std::int32_t>::max(),
+      std::numeric_limits<std::int32_t>::max()};
+  CHECK((all(big) | avg()) ==
+        static_cast<double>(std::numeric_limits<std::int32_t>::max()));
+}
+
+TEST_CASE("top k") {
+  auto const v = std::vector<int>{5, 1, 9, 3, 7, 9, 2};
+  CHECK((all(v) | top_k(3U)) == std::vector<int>{9, 9, 7});
+  CHECK((all(v) | top_k(2U, std::greater<>{})) == std::vector<int>{1, 2});
+  CHECK((all(v) | top_k(0U)).empty());
+  CHECK((all(v) | top_k(100U)).size() == v.size());
+
+  thread_pool pool;
+  CHECK((iota(0, 10000) | par(pool, 97U) | top_k(4U)) ==
+        std::vector<int>{9999, 9998, 9997, 9996});
+}
+
+TEST_CASE("min max") {
+  auto const v = std::vector<int>{5, 1, 9, 3, 7};
+  CHECK((all(v) | min_max()) == std::pair{1, 9});
+  CHECK_FALSE((iota(0, 0) | min_max()).has_value());
+
+  thread_pool pool;
+  CHECK((iota(-500, 500) | par(pool, 33U) | min_max()) == std::pair{-500, 499});
+}
+
+TEST_CASE("mean var") {
+  auto const v = std::vector<double>{2, 4, 4, 4, 5, 5, 7, 9};
+  auto const mv = all(v) | mean_var();
+  CHECK(mv.count_ == 8U);
+  CHECK(mv.mean() == Catch::Approx(5.0));
+  CHECK(mv.variance() == Catch::Approx(4.0));
+  CHECK(mv.sample_variance() == Catch::Approx(32.0 / 7.0));
+
+  thread_pool pool;
+  auto const seq = iota(0, 10000) | mean_var();
+  auto const par_mv = iota(0, 10000) | par(pool, 123U) | mean_var();
+  CHECK(par_mv.count_ == seq.count_);
+  CHECK(par_mv.mean() == Catch::Approx(seq.mean()));
+  CHECK(par_mv.variance() == Catch::Approx(seq.variance()));
+}
+
+TEST_CASE("quantiles") {
+  CHECK((iota(1, 101) | quantiles({0.0, 0.5, 0.99, 1.0})) ==
+        std::vector<int>{1, 50, 99, 100});
+  CHECK((iota(0, 0) | quantiles({0.5})).empty());
+
+  // Exact up to k elements, approximate from the first compaction on.
+  auto const permute_small = [](int const m) {
+    return [m](int const i) { return (i * 7919) % m; };
+  };
+  CHECK((iota(0, 200) | transform(permute_small(200)) |
+         quantiles({0.0, 0.5, 1.0}, 200U)) == std::vector<int>{0, 99, 199});
+  auto const above_k = iota(0, 300) | transform(permute_small(300)) |
+                       quantiles({0.5}, 200U);
+  REQUIRE(above_k.size() == 1U);
+  CHECK(std::abs(above_k[0] - 149) <= 6);
+
+  auto const n = 1000000;
+  auto const permuted = [&](int const i) {
+    return static_cast<int>((static_cast<std::int64_t>(i) * 7919) % n);
+  };
+  auto const within = [&](int const actual, double const p) {
+    return std::abs(actual - p * n) < 0.02 * n;
+  };
+
+  auto const q = iota(0, n) | transform(permuted) | quantiles({0.5, 0.99});
+  REQUIRE(q.size() == 2U);
+  CHECK(within(q[0], 0.5));
+  CHECK(within(q[1], 0.99));
+
+  thread_pool pool;
+  auto const par_q =
+      iota(0, n) | par(pool, 10000U) | transform(permuted) |
+      quantiles({0.5, 0.99});
+  REQUIRE(par_q.size() == 2U);
+  CHECK(within(par_q[0], 0.5));
+  CHECK(within(par_q[1], 0.99));
+}
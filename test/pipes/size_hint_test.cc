@@ -0,0 +1,91 @@
+#include "catch2/catch_all.hpp"
+
+#include <list>
+#include <numeric>
+#include <unordered_set>
+#include <vector>
+
+#include "utl/pipes.h"
+
+using namespace utl;
+
+namespace {
+
+// Only *, ++ and != - no iterator_traits.
+struct minimal_it {
+  int operator*() const { return i_; }
+  minimal_it& operator++() {
+    ++i_;
+    return *this;
+  }
+  bool operator!=(minimal_it const& o) const { return i_ != o.i_; }
+  int i_;
+};
+
+struct minimal_sentinel {};
+
+bool operator!=(minimal_it const& it, minimal_sentinel) { return it.i_ != 5; }
+
+}  // namespace
+
+TEST_CASE("size hint") {
+  auto v = std::vector<int>(100U);
+  std::iota(begin(v), end(v), 0);
+  auto const l = std::list<int>{1, 2, 3};
+  auto const twice = [](int const i) { return 2 * i; };
+  auto const is_odd = [](int const i) { return i % 2 == 1; };
+
+  CHECK((all(v) | transform(twice)).size_hint() == 100U);
+  CHECK((iota(10, 20) | remove_if(is_odd)).size_hint() == 10U);
+  CHECK((iota(20, 10)).size_hint() == 0U);
+  CHECK(has_exact_size_v<decltype(all(v) | transform(twice))>);
+  CHECK(has_size_hint_v<decltype(iota(10, 20) | remove_if(is_odd))>);
+  CHECK_FALSE(has_exact_size_v<decltype(iota(10, 20) | remove_if(is_odd))>);
+  CHECK_FALSE(has_exact_size_v<decltype(iota(10, 20) | remove_if(is_odd) |
+                                        transform(twice))>);
+  CHECK_FALSE(has_size_hint_v<decltype(all(l))>);
+  CHECK_FALSE(has_size_hint_v<decltype(all(v) | unique())>);
+  CHECK_FALSE(has_size_hint_v<decltype(all(v) | take_while(is_odd))>);
+}
+
+TEST_CASE("size hint reserve") {
+  auto v = std::vector<int>(100U);
+  std::iota(begin(v), end(v), 0);
+
+  auto const exact =
+      all(v) | transform([](int const i) { return i + 1; }) | vec();
+  CHECK(exact.size() == 100U);
+  CHECK(exact.capacity() == 100U);
+
+  // Only exact sizes are reserved: a filter does not reserve its input size.
+  auto const filtered = iota(0, 1000000) |
+                        remove_if([](int const i) { return i >= 10; }) | vec();
+  CHECK(filtered.size() == 10U);
+  CHECK(filtered.capacity() < 100U);
+
+  auto const filtered_set = iota(0, 1000000) |
+                            remove_if([](int const i) { return i >= 10; }) |
+                            to<std::unordered_set<int>>();
+  CHECK(filtered_set.size() == 10U);
+  CHECK(filtered_set.bucket_count() < 1000U);
+
+  auto const back = iota(0U, 50U) | emplace_back_to<std::vector<unsigned>>();
+  CHECK(back.capacity() == 50U);
+
+  auto const set = iota(0U, 50U) | to<std::unordered_set<unsigned>>();
+  CHECK(set.size() == 50U);
+}
+
+TEST_CASE("size hint minimal iterator") {
+  auto const twice = [](int const i) { return 2 * i; };
+
+  auto const a = all(minimal_it{0}, minimal_it{3}) | transform(twice) | vec();
+  CHECK(a == std::vector<int>{0, 2, 4});
+  CHECK_FALSE(has_size_hint_v<decltype(all(minimal_it{0}, minimal_it{3}))>);
+
+  auto const b = all(minimal_it{0}, minimal_sentinel{}) | vec();
+  CHECK(b == std::vector<int>{0, 1, 2, 3, 4});
+  CHECK((all(minimal_it{0}, minimal_it{4}) | sum()) == 6U);
+  CHECK((all(minimal_it{0}, minimal_it{4}) |
+         count([](int const i) { return i % 2 == 0; })) == 2U);
+}